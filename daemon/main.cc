@@ -0,0 +1,31 @@
+#include <lfsnowflake/ipc.h>
+#include <signal.h>
+
+#include <iostream>
+#include <thread>
+
+/*serves lf::get ids over a UNIX domain socket until SIGINT or SIGTERM*/
+auto main(int argc, char** argv) -> int {
+  char const* path = (argc > 1) ? argv[1] : "/tmp/lfsnowflake.sock";
+
+  // handled by sigwait below, blocked before any thread inherits the mask
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  lf::ipc::Server server(path);
+  if (!server.isOpen()) {
+    std::cerr << "failed to listen on " << path << std::endl;
+    return 1;
+  }
+  std::cout << "serving ids on " << path << std::endl;
+
+  std::jthread serverThread(
+      [&server](std::stop_token stopToken) { server.run(stopToken); });
+
+  int signal;
+  sigwait(&signals, &signal);
+  return 0;
+}
@@ -0,0 +1,648 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "bulk.h"
+#include "layout.h"
+
+namespace lf {
+namespace archive {
+
+// Compressed storage of ascending snowflakes in blocks of kBlockSize ids.
+// Time ordered ids share their high bits, so a block keeps the first id,
+// the timestamps as runs (timestamp delta to the previous run, run length)
+// and the low bits below the timestamp (MPID and sequence) as deltas to the
+// previous id of the same run, or to the smallest run start (frame of
+// reference) for the first id of a run. Deltas are bit packed at the widest
+// delta's width, interleaved over kLaneCount lanes so AVX2 packs and unpacks
+// kLaneCount ids per step.
+//
+// BLOCK FORMAT (u64 words):
+// |--BlockHeader--|--run timestamp deltas--|--run lengths - 1--|--deltas--|
+//
+// FILE FORMAT: |--FileHeader--|--blocks--|--IndexEntry per block--|
+// The index keeps the first and last id of every block, a Reader seeks to a
+// timestamp range through it and decodes only the blocks in the range.
+
+inline constexpr std::size_t kBlockSize = 1'024;
+inline constexpr std::size_t kLaneCount = 4;
+
+struct BlockHeader {
+  u64 firstId;
+  u64 lastId;
+  // smallest low bits of a run's first id
+  u64 lowBase;
+  std::uint32_t count;
+  std::uint32_t runCount;
+  std::uint8_t deltaWidth;
+  std::uint8_t runTimestampWidth;
+  std::uint8_t runLengthWidth;
+  std::uint8_t reserved[5];
+};
+
+static_assert(sizeof(BlockHeader) % sizeof(u64) == 0);
+
+namespace detail {
+inline constexpr std::size_t kHeaderWordCount =
+    sizeof(BlockHeader) / sizeof(u64);
+
+inline constexpr u64 widthMask(u64 width) noexcept {
+  return width >= 64ull ? ~0ull : (1ull << width) - 1ull;
+}
+
+inline constexpr std::size_t packedWordCount(std::size_t count,
+                                             u64 width) noexcept {
+  return static_cast<std::size_t>((count * width + 63ull) / 64ull);
+}
+
+inline u64 maxWidth(std::span<u64 const> values) noexcept {
+  u64 bits = 0ull;
+  for (auto const value : values) {
+    bits |= value;
+  }
+  return static_cast<u64>(std::bit_width(bits));
+}
+
+// sequential bit packing for the (few) runs of a block
+inline void packSequential(std::span<u64 const> values, u64 width,
+                           u64* words) noexcept {
+  std::fill_n(words, packedWordCount(std::size(values), width), 0ull);
+  for (std::size_t i = 0; i < std::size(values) && width != 0ull; i++) {
+    auto const bit = i * width;
+    auto const shift = bit % 64ull;
+    words[bit / 64ull] |= values[i] << shift;
+    if (shift + width > 64ull) {
+      words[bit / 64ull + 1] |= values[i] >> (64ull - shift);
+    }
+  }
+}
+
+inline u64 unpackSequential(u64 const* words, std::size_t index,
+                            u64 width) noexcept {
+  if (width == 0ull) {
+    return 0ull;
+  }
+  auto const bit = index * width;
+  auto const shift = bit % 64ull;
+  auto value = words[bit / 64ull] >> shift;
+  if (shift + width > 64ull) {
+    value |= words[bit / 64ull + 1] << (64ull - shift);
+  }
+  return value & widthMask(width);
+}
+}  // namespace detail
+
+// Interleaved packing of kBlockSize deltas: delta i is in lane i % kLaneCount
+// at bit (i / kLaneCount) * width of the lane, word k of lane l is stored at
+// k * kLaneCount + l. A block of deltas takes kBlockSize * width / 64 words.
+namespace scalar {
+inline void pack(std::span<u64 const, kBlockSize> deltas, u64 width,
+                 u64* words) noexcept {
+  std::fill_n(words, detail::packedWordCount(kBlockSize, width), 0ull);
+  if (width == 0ull) {
+    return;
+  }
+  for (std::size_t i = 0; i < kBlockSize; i++) {
+    auto const lane = i % kLaneCount;
+    auto const bit = (i / kLaneCount) * width;
+    auto const shift = bit % 64ull;
+    auto const word = (bit / 64ull) * kLaneCount + lane;
+    words[word] |= deltas[i] << shift;
+    if (shift + width > 64ull) {
+      words[word + kLaneCount] |= deltas[i] >> (64ull - shift);
+    }
+  }
+}
+
+inline void unpack(u64 const* words, u64 width,
+                   std::span<u64, kBlockSize> deltas) noexcept {
+  if (width == 0ull) {
+    std::fill(std::begin(deltas), std::end(deltas), 0ull);
+    return;
+  }
+  auto const mask = detail::widthMask(width);
+  for (std::size_t i = 0; i < kBlockSize; i++) {
+    auto const lane = i % kLaneCount;
+    auto const bit = (i / kLaneCount) * width;
+    auto const shift = bit % 64ull;
+    auto const word = (bit / 64ull) * kLaneCount + lane;
+    auto value = words[word] >> shift;
+    if (shift + width > 64ull) {
+      value |= words[word + kLaneCount] << (64ull - shift);
+    }
+    deltas[i] = value & mask;
+  }
+}
+}  // namespace scalar
+
+#if defined(__x86_64__) || defined(__i386__)
+namespace avx2 {
+// every lane is at the same bit offset, one vector shift serves 4 ids
+__attribute__((target("avx2"))) inline void pack(
+    std::span<u64 const, kBlockSize> deltas, u64 width, u64* words) noexcept {
+  if (width == 0ull) {
+    return;
+  }
+  auto* out = reinterpret_cast<__m256i*>(words);
+  auto accumulator = _mm256_setzero_si256();
+  u64 shift = 0ull;
+  for (std::size_t i = 0; i < kBlockSize; i += kLaneCount) {
+    auto const delta = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(std::data(deltas) + i));
+    auto const shiftCount = _mm_cvtsi64_si128(static_cast<long long>(shift));
+    accumulator =
+        _mm256_or_si256(accumulator, _mm256_sll_epi64(delta, shiftCount));
+    shift += width;
+    if (shift >= 64ull) {
+      _mm256_storeu_si256(out++, accumulator);
+      shift -= 64ull;
+      // the bits that did not fit start the next word
+      auto const carryCount =
+          _mm_cvtsi64_si128(static_cast<long long>(width - shift));
+      accumulator = shift == 0ull ? _mm256_setzero_si256()
+                                  : _mm256_srl_epi64(delta, carryCount);
+    }
+  }
+}
+
+__attribute__((target("avx2"))) inline void unpack(
+    u64 const* words, u64 width, std::span<u64, kBlockSize> deltas) noexcept {
+  if (width == 0ull) {
+    std::fill(std::begin(deltas), std::end(deltas), 0ull);
+    return;
+  }
+  auto const* in = reinterpret_cast<__m256i const*>(words);
+  auto const mask =
+      _mm256_set1_epi64x(static_cast<long long>(detail::widthMask(width)));
+  auto word = _mm256_loadu_si256(in);
+  u64 shift = 0ull;
+  for (std::size_t i = 0; i < kBlockSize; i += kLaneCount) {
+    auto value = _mm256_srl_epi64(
+        word, _mm_cvtsi64_si128(static_cast<long long>(shift)));
+    shift += width;
+    if (shift >= 64ull) {
+      shift -= 64ull;
+      if (i + kLaneCount < kBlockSize || shift != 0ull) {
+        word = _mm256_loadu_si256(++in);
+      }
+      if (shift != 0ull) {
+        value = _mm256_or_si256(
+            value, _mm256_sll_epi64(word, _mm_cvtsi64_si128(
+                                              static_cast<long long>(
+                                                  width - shift))));
+      }
+    }
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(std::data(deltas) + i),
+        _mm256_and_si256(value, mask));
+  }
+}
+}  // namespace avx2
+#endif
+
+namespace detail {
+inline void pack(std::span<u64 const, kBlockSize> deltas, u64 width,
+                 u64* words, bulk::Isa isa) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  if (isa != bulk::Isa::kScalar) {
+    return avx2::pack(deltas, width, words);
+  }
+#endif
+  (void)isa;
+  scalar::pack(deltas, width, words);
+}
+
+inline void unpack(u64 const* words, u64 width,
+                   std::span<u64, kBlockSize> deltas, bulk::Isa isa) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  if (isa != bulk::Isa::kScalar) {
+    return avx2::unpack(words, width, deltas);
+  }
+#endif
+  (void)isa;
+  scalar::unpack(words, width, deltas);
+}
+}  // namespace detail
+
+// number of words of the encoded block starting at block
+inline std::size_t blockWordCount(u64 const* block) noexcept {
+  BlockHeader header;
+  std::memcpy(&header, block, sizeof(header));
+  return detail::kHeaderWordCount +
+         detail::packedWordCount(header.runCount, header.runTimestampWidth) +
+         detail::packedWordCount(header.runCount, header.runLengthWidth) +
+         detail::packedWordCount(kBlockSize, header.deltaWidth);
+}
+
+// whether the wordCount words at block start with a complete block whose runs
+// decode to at most kBlockSize ids
+inline bool isValidBlock(u64 const* block, std::size_t wordCount) noexcept {
+  if (wordCount < detail::kHeaderWordCount) {
+    return false;
+  }
+  BlockHeader header;
+  std::memcpy(&header, block, sizeof(header));
+  if ((header.count == 0u) || (header.count > kBlockSize) ||
+      (header.runCount == 0u) || (header.runCount > header.count) ||
+      (header.deltaWidth > 64u) || (header.runTimestampWidth > 64u) ||
+      (header.runLengthWidth > 64u) || (blockWordCount(block) > wordCount)) {
+    return false;
+  }
+
+  // the run lengths must add up to the id count
+  auto const* runLengths =
+      block + detail::kHeaderWordCount +
+      detail::packedWordCount(header.runCount, header.runTimestampWidth);
+  std::size_t count = 0;
+  for (std::size_t run = 0; run < header.runCount; run++) {
+    auto const length =
+        detail::unpackSequential(runLengths, run, header.runLengthWidth);
+    if (length >= header.count - count) {
+      return false;
+    }
+    count += static_cast<std::size_t>(length) + 1;
+  }
+  return count == header.count;
+}
+
+// appends the block of the ascending ids (at most kBlockSize) to out
+template <typename LayoutT = DefaultLayout>
+inline void encodeBlock(std::span<u64 const> ids, std::vector<u64>& out,
+                        bulk::Isa isa = bulk::detectIsa()) {
+  static_assert(LayoutT::kTimestampShift < 64ull);
+  constexpr u64 kLowMask = (1ull << LayoutT::kTimestampShift) - 1ull;
+  auto const count = std::min(std::size(ids), kBlockSize);
+  if (count == 0) {
+    return;
+  }
+
+  // timestamp runs
+  std::array<u64, kBlockSize> runTimestamps;
+  std::array<u64, kBlockSize> runLengths;
+  std::size_t runCount = 0;
+  u64 lowBase = ~0ull;
+  u64 previousTimestamp = ids[0] >> LayoutT::kTimestampShift;
+  for (std::size_t i = 0; i < count; i++) {
+    auto const timestamp = ids[i] >> LayoutT::kTimestampShift;
+    if (i == 0 || timestamp != previousTimestamp) {
+      runTimestamps[runCount] = timestamp - previousTimestamp;
+      runLengths[runCount] = 0ull;
+      runCount++;
+      lowBase = std::min(lowBase, ids[i] & kLowMask);
+      previousTimestamp = timestamp;
+    } else {
+      runLengths[runCount - 1]++;
+    }
+  }
+
+  // low bit deltas, the unused tail of a short block is zero
+  std::array<u64, kBlockSize> deltas{};
+  for (std::size_t i = 0, run = 0, end = 0; i < count; i++) {
+    if (i == end) {
+      deltas[i] = (ids[i] & kLowMask) - lowBase;
+      end += runLengths[run++] + 1ull;
+    } else {
+      deltas[i] = (ids[i] & kLowMask) - (ids[i - 1] & kLowMask);
+    }
+  }
+
+  BlockHeader header{};
+  header.firstId = ids[0];
+  header.lastId = ids[count - 1];
+  header.lowBase = lowBase;
+  header.count = static_cast<std::uint32_t>(count);
+  header.runCount = static_cast<std::uint32_t>(runCount);
+  header.deltaWidth = static_cast<std::uint8_t>(detail::maxWidth(deltas));
+  header.runTimestampWidth = static_cast<std::uint8_t>(
+      detail::maxWidth(std::span(runTimestamps).first(runCount)));
+  header.runLengthWidth = static_cast<std::uint8_t>(
+      detail::maxWidth(std::span(runLengths).first(runCount)));
+
+  auto const offset = std::size(out);
+  out.resize(offset + detail::kHeaderWordCount +
+             detail::packedWordCount(runCount, header.runTimestampWidth) +
+             detail::packedWordCount(runCount, header.runLengthWidth) +
+             detail::packedWordCount(kBlockSize, header.deltaWidth));
+  auto* words = std::data(out) + offset;
+  std::memcpy(words, &header, sizeof(header));
+  words += detail::kHeaderWordCount;
+  detail::packSequential(std::span(runTimestamps).first(runCount),
+                         header.runTimestampWidth, words);
+  words += detail::packedWordCount(runCount, header.runTimestampWidth);
+  detail::packSequential(std::span(runLengths).first(runCount),
+                         header.runLengthWidth, words);
+  words += detail::packedWordCount(runCount, header.runLengthWidth);
+  detail::pack(deltas, header.deltaWidth, words, isa);
+}
+
+// decodes the block into out (at least kBlockSize ids), returns the id count
+template <typename LayoutT = DefaultLayout>
+inline std::size_t decodeBlock(u64 const* block, std::span<u64> out,
+                               bulk::Isa isa = bulk::detectIsa()) noexcept {
+  BlockHeader header;
+  std::memcpy(&header, block, sizeof(header));
+  auto const* runTimestamps = block + detail::kHeaderWordCount;
+  auto const* runLengths =
+      runTimestamps +
+      detail::packedWordCount(header.runCount, header.runTimestampWidth);
+  auto const* deltas =
+      runLengths +
+      detail::packedWordCount(header.runCount, header.runLengthWidth);
+
+  auto const decoded = out.first<kBlockSize>();
+  detail::unpack(deltas, header.deltaWidth, decoded, isa);
+
+  // prefix sums of the deltas per run, the timestamp is or'ed on top
+  auto timestamp = header.firstId >> LayoutT::kTimestampShift;
+  std::size_t i = 0;
+  for (std::size_t run = 0; run < header.runCount; run++) {
+    timestamp += detail::unpackSequential(runTimestamps, run,
+                                          header.runTimestampWidth);
+    auto const end = i + 1 +
+                     detail::unpackSequential(runLengths, run,
+                                              header.runLengthWidth);
+    auto const high = timestamp << LayoutT::kTimestampShift;
+    auto low = header.lowBase;
+    // the first delta of a run is relative to lowBase, the rest chain
+    for (; i < end; i++) {
+      low += decoded[i];
+      decoded[i] = high | low;
+    }
+  }
+  return header.count;
+}
+
+struct FileHeader {
+  u64 magic;
+  std::uint32_t version;
+  // LayoutT::kTimestampShift of the writer, a reader must match it
+  std::uint32_t timestampShift;
+  u64 idCount;
+  u64 blockCount;
+  // byte offset of the block index
+  u64 indexOffset;
+};
+
+struct IndexEntry {
+  u64 firstId;
+  u64 lastId;
+  // byte offset of the block
+  u64 offset;
+};
+
+inline constexpr u64 kMagic = 0x4c46534e'4f574152ull;  // LFSNOWAR
+inline constexpr std::uint32_t kVersion = 1u;
+
+namespace detail {
+inline bool writeAll(int fd, void const* data, std::size_t size) noexcept {
+  auto const* bytes = static_cast<unsigned char const*>(data);
+  while (size != 0) {
+    auto const count = ::write(fd, bytes, size);
+    if (count <= 0) {
+      if ((count < 0) && (errno == EINTR)) {
+        continue;
+      }
+      return false;
+    }
+    bytes += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+}  // namespace detail
+
+// Appends ascending ids to an archive file, the index and the header are
+// written by finish() (or the destructor). An id below the previous one is
+// rejected, append() then returns false and the archive stays valid.
+template <typename LayoutT = DefaultLayout>
+class Writer {
+ public:
+  explicit Writer(char const* path) noexcept {
+    m_Fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    FileHeader header{};
+    if ((m_Fd >= 0) && !detail::writeAll(m_Fd, &header, sizeof(header))) {
+      close();
+    }
+    m_Offset = sizeof(header);
+    m_Pending.reserve(kBlockSize);
+  }
+
+  ~Writer() noexcept { finish(); }
+
+  Writer(Writer const&) = delete;
+  Writer& operator=(Writer const&) = delete;
+
+  bool isOpen() const noexcept { return m_Fd >= 0; }
+
+  bool append(std::span<u64 const> ids) {
+    for (auto const id : ids) {
+      if (!isOpen() || (m_IdCount != 0ull && id < m_LastId)) {
+        return false;
+      }
+      m_Pending.push_back(id);
+      m_LastId = id;
+      m_IdCount++;
+      if ((std::size(m_Pending) == kBlockSize) && !flush()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // writes the last block, the index and the header and closes the file,
+  // returns false if any of them could not be encoded or written
+  bool finish() noexcept {
+    if (!isOpen()) {
+      return false;
+    }
+    // also runs from the destructor, a failed allocation must not escape
+    auto isWritten = false;
+    try {
+      isWritten = flush();
+    } catch (std::bad_alloc const&) {
+      isWritten = false;
+    }
+    FileHeader const header{
+        kMagic,    kVersion,
+        static_cast<std::uint32_t>(LayoutT::kTimestampShift),
+        m_IdCount, std::size(m_Index),
+        m_Offset};
+    isWritten = isWritten &&
+                detail::writeAll(m_Fd, std::data(m_Index),
+                                 std::size(m_Index) * sizeof(IndexEntry)) &&
+                (::pwrite(m_Fd, &header, sizeof(header), 0) ==
+                 static_cast<ssize_t>(sizeof(header)));
+    close();
+    return isWritten;
+  }
+
+ private:
+  bool flush() {
+    if (m_Pending.empty()) {
+      return true;
+    }
+    m_Block.clear();
+    encodeBlock<LayoutT>(m_Pending, m_Block);
+    m_Index.push_back({m_Pending.front(), m_Pending.back(), m_Offset});
+    m_Pending.clear();
+    auto const size = std::size(m_Block) * sizeof(u64);
+    m_Offset += size;
+    return detail::writeAll(m_Fd, std::data(m_Block), size);
+  }
+
+  void close() noexcept {
+    if (m_Fd >= 0) {
+      ::close(m_Fd);
+      m_Fd = -1;
+    }
+  }
+
+  int m_Fd = -1;
+  u64 m_Offset = 0ull;
+  u64 m_IdCount = 0ull;
+  u64 m_LastId = 0ull;
+  std::vector<u64> m_Pending;
+  std::vector<u64> m_Block;
+  std::vector<IndexEntry> m_Index;
+};
+
+// Read only mapping of an archive file. Blocks are decoded on demand, a
+// timestamp range visits only the blocks the index selects.
+template <typename LayoutT = DefaultLayout>
+class Reader {
+ public:
+  explicit Reader(char const* path) noexcept {
+    m_Fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if ((m_Fd < 0) || (::fstat(m_Fd, &status) != 0) ||
+        (static_cast<std::size_t>(status.st_size) < sizeof(FileHeader))) {
+      close();
+      return;
+    }
+    m_Size = static_cast<std::size_t>(status.st_size);
+
+    void* mapping = ::mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, m_Fd, 0);
+    if (mapping == MAP_FAILED) {
+      close();
+      return;
+    }
+    m_Data = static_cast<unsigned char const*>(mapping);
+
+    std::memcpy(&m_Header, m_Data, sizeof(m_Header));
+    // the index lies between the header and the end of the file
+    auto const indexOffset = m_Header.indexOffset;
+    if ((m_Header.magic != kMagic) || (m_Header.version != kVersion) ||
+        (m_Header.timestampShift != LayoutT::kTimestampShift) ||
+        (indexOffset < sizeof(FileHeader)) || (indexOffset > m_Size) ||
+        (indexOffset % sizeof(u64) != 0ull) ||
+        (m_Header.blockCount > (m_Size - indexOffset) / sizeof(IndexEntry))) {
+      close();
+      return;
+    }
+    m_Index = std::span(
+        reinterpret_cast<IndexEntry const*>(m_Data + indexOffset),
+        m_Header.blockCount);
+
+    // every block lies between the header and the index
+    for (auto const& entry : m_Index) {
+      if ((entry.offset < sizeof(FileHeader)) || (entry.offset > indexOffset) ||
+          (entry.offset % sizeof(u64) != 0ull) ||
+          !isValidBlock(reinterpret_cast<u64 const*>(m_Data + entry.offset),
+                        static_cast<std::size_t>(indexOffset - entry.offset) /
+                            sizeof(u64))) {
+        close();
+        return;
+      }
+    }
+  }
+
+  ~Reader() noexcept { close(); }
+
+  Reader(Reader const&) = delete;
+  Reader& operator=(Reader const&) = delete;
+
+  bool isOpen() const noexcept { return m_Data != nullptr; }
+
+  u64 idCount() const noexcept { return m_Header.idCount; }
+  std::size_t blockCount() const noexcept { return std::size(m_Index); }
+  // size of the archive file in bytes
+  std::size_t byteCount() const noexcept { return m_Size; }
+
+  // decodes block into out (at least kBlockSize ids), returns the id count
+  std::size_t decode(std::size_t block, std::span<u64> out,
+                     bulk::Isa isa = bulk::detectIsa()) const noexcept {
+    return decodeBlock<LayoutT>(
+        reinterpret_cast<u64 const*>(m_Data + m_Index[block].offset), out,
+        isa);
+  }
+
+  // calls visit(id) for the ids with timestamps [ticks] in [from, to],
+  // returns the number of blocks decoded
+  template <typename Visitor>
+  std::size_t forEachInRange(u64 from, u64 to, Visitor&& visit) const {
+    auto const lowest = from << LayoutT::kTimestampShift;
+    auto const highest = (to << LayoutT::kTimestampShift) bitor
+                         ((1ull << LayoutT::kTimestampShift) - 1ull);
+    // first block that ends at or after the range
+    auto block = static_cast<std::size_t>(
+        std::partition_point(std::begin(m_Index), std::end(m_Index),
+                             [&](IndexEntry const& entry) {
+                               return entry.lastId < lowest;
+                             }) -
+        std::begin(m_Index));
+
+    std::array<u64, kBlockSize> ids;
+    std::size_t decodedCount = 0;
+    for (; block < std::size(m_Index) && m_Index[block].firstId <= highest;
+         block++) {
+      auto const count = decode(block, ids);
+      for (std::size_t i = 0; i < count; i++) {
+        if (ids[i] >= lowest && ids[i] <= highest) {
+          visit(ids[i]);
+        }
+      }
+      decodedCount++;
+    }
+    return decodedCount;
+  }
+
+ private:
+  void close() noexcept {
+    if (m_Data != nullptr) {
+      ::munmap(const_cast<unsigned char*>(m_Data), m_Size);
+      m_Data = nullptr;
+    }
+    if (m_Fd >= 0) {
+      ::close(m_Fd);
+      m_Fd = -1;
+    }
+    m_Index = {};
+  }
+
+  int m_Fd = -1;
+  std::size_t m_Size = 0;
+  unsigned char const* m_Data = nullptr;
+  FileHeader m_Header{};
+  std::span<IndexEntry const> m_Index;
+};
+
+}  // namespace archive
+}  // namespace lf
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "layout.h"
+
+namespace lf {
+namespace bulk {
+
+// Span based encode/decode of snowflake arrays. Every kernel processes
+// std::size(snowflakes) elements, the component spans must be at least as
+// large. lf::bulk::encode picks the widest kernel the cpu supports at runtime.
+// lf::bulk::decode always runs the scalar loop: the compiler vectorizes it and
+// it outruns the hand written kernels in -bulk, decode is bound by its three
+// store streams. The per instruction set kernels are exposed for benchmarking.
+
+namespace scalar {
+template <typename LayoutT = DefaultLayout>
+inline void decode(std::span<u64 const> snowflakes, std::span<u64> timestamps,
+                   std::span<u64> mpids, std::span<u64> sequences) noexcept {
+  for (std::size_t i = 0; i < std::size(snowflakes); i++) {
+    timestamps[i] = LayoutT::getTimestamp(snowflakes[i]);
+    mpids[i] = LayoutT::getMpid(snowflakes[i]);
+    sequences[i] = LayoutT::getSequence(snowflakes[i]);
+  }
+}
+
+template <typename LayoutT = DefaultLayout>
+inline void encode(std::span<u64 const> timestamps, std::span<u64 const> mpids,
+                   std::span<u64 const> sequences,
+                   std::span<u64> snowflakes) noexcept {
+  for (std::size_t i = 0; i < std::size(snowflakes); i++) {
+    snowflakes[i] = LayoutT::make(timestamps[i], mpids[i], sequences[i]);
+  }
+}
+}  // namespace scalar
+
+#if defined(__x86_64__) || defined(__i386__)
+namespace avx2 {
+template <typename LayoutT = DefaultLayout>
+__attribute__((target("avx2"))) inline void decode(
+    std::span<u64 const> snowflakes, std::span<u64> timestamps,
+    std::span<u64> mpids, std::span<u64> sequences) noexcept {
+  auto const mpidMask = _mm256_set1_epi64x(
+      static_cast<long long>(LayoutT::kMpidMask >> LayoutT::kMpidShift));
+  auto const sequenceMask = _mm256_set1_epi64x(
+      static_cast<long long>(LayoutT::kSequenceMask));
+  auto const timestampMask = _mm256_set1_epi64x(static_cast<long long>(
+      LayoutT::kTimestampMask >> LayoutT::kTimestampShift));
+
+  std::size_t i = 0;
+  for (; i + 4 <= std::size(snowflakes); i += 4) {
+    auto const snowflake = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(std::data(snowflakes) + i));
+    auto const timestamp = _mm256_and_si256(
+        _mm256_srli_epi64(snowflake, LayoutT::kTimestampShift), timestampMask);
+    auto const mpid = _mm256_and_si256(
+        _mm256_srli_epi64(snowflake, LayoutT::kMpidShift), mpidMask);
+    auto const sequence = _mm256_and_si256(snowflake, sequenceMask);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(std::data(timestamps) + i),
+                        timestamp);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(std::data(mpids) + i),
+                        mpid);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(std::data(sequences) + i),
+                        sequence);
+  }
+  scalar::decode<LayoutT>(snowflakes.subspan(i), timestamps.subspan(i),
+                          mpids.subspan(i), sequences.subspan(i));
+}
+
+template <typename LayoutT = DefaultLayout>
+__attribute__((target("avx2"))) inline void encode(
+    std::span<u64 const> timestamps, std::span<u64 const> mpids,
+    std::span<u64 const> sequences, std::span<u64> snowflakes) noexcept {
+  auto const mpidMask = _mm256_set1_epi64x(
+      static_cast<long long>(LayoutT::kMpidMask));
+  auto const sequenceMask = _mm256_set1_epi64x(
+      static_cast<long long>(LayoutT::kSequenceMask));
+  auto const timestampMask = _mm256_set1_epi64x(
+      static_cast<long long>(LayoutT::kTimestampMask));
+
+  std::size_t i = 0;
+  for (; i + 4 <= std::size(snowflakes); i += 4) {
+    auto const timestamp = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(std::data(timestamps) + i));
+    auto const mpid = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(std::data(mpids) + i));
+    auto const sequence = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(std::data(sequences) + i));
+    auto const snowflake = _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_and_si256(
+                _mm256_slli_epi64(timestamp, LayoutT::kTimestampShift),
+                timestampMask),
+            _mm256_and_si256(_mm256_slli_epi64(mpid, LayoutT::kMpidShift),
+                             mpidMask)),
+        _mm256_and_si256(sequence, sequenceMask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(std::data(snowflakes) + i),
+                        snowflake);
+  }
+  scalar::encode<LayoutT>(timestamps.subspan(i), mpids.subspan(i),
+                          sequences.subspan(i), snowflakes.subspan(i));
+}
+}  // namespace avx2
+
+namespace avx512 {
+// the maskz shifts avoid gcc 12's -Wmaybe-uninitialized in _mm512_s?li_epi64
+inline constexpr __mmask8 kAllLanes = 0xff;
+
+template <typename LayoutT = DefaultLayout>
+__attribute__((target("avx512f"))) inline void decode(
+    std::span<u64 const> snowflakes, std::span<u64> timestamps,
+    std::span<u64> mpids, std::span<u64> sequences) noexcept {
+  auto const mpidMask = _mm512_set1_epi64(
+      static_cast<long long>(LayoutT::kMpidMask >> LayoutT::kMpidShift));
+  auto const sequenceMask =
+      _mm512_set1_epi64(static_cast<long long>(LayoutT::kSequenceMask));
+  auto const timestampMask = _mm512_set1_epi64(static_cast<long long>(
+      LayoutT::kTimestampMask >> LayoutT::kTimestampShift));
+
+  std::size_t i = 0;
+  for (; i + 8 <= std::size(snowflakes); i += 8) {
+    auto const snowflake = _mm512_loadu_si512(std::data(snowflakes) + i);
+    auto const timestamp =
+        _mm512_and_si512(_mm512_maskz_srli_epi64(kAllLanes, snowflake,
+                                                 LayoutT::kTimestampShift),
+                         timestampMask);
+    auto const mpid = _mm512_and_si512(
+        _mm512_maskz_srli_epi64(kAllLanes, snowflake, LayoutT::kMpidShift),
+        mpidMask);
+    auto const sequence = _mm512_and_si512(snowflake, sequenceMask);
+    _mm512_storeu_si512(std::data(timestamps) + i, timestamp);
+    _mm512_storeu_si512(std::data(mpids) + i, mpid);
+    _mm512_storeu_si512(std::data(sequences) + i, sequence);
+  }
+  avx2::decode<LayoutT>(snowflakes.subspan(i), timestamps.subspan(i),
+                        mpids.subspan(i), sequences.subspan(i));
+}
+
+template <typename LayoutT = DefaultLayout>
+__attribute__((target("avx512f"))) inline void encode(
+    std::span<u64 const> timestamps, std::span<u64 const> mpids,
+    std::span<u64 const> sequences, std::span<u64> snowflakes) noexcept {
+  auto const mpidMask =
+      _mm512_set1_epi64(static_cast<long long>(LayoutT::kMpidMask));
+  auto const sequenceMask =
+      _mm512_set1_epi64(static_cast<long long>(LayoutT::kSequenceMask));
+  auto const timestampMask =
+      _mm512_set1_epi64(static_cast<long long>(LayoutT::kTimestampMask));
+
+  std::size_t i = 0;
+  for (; i + 8 <= std::size(snowflakes); i += 8) {
+    auto const timestamp = _mm512_loadu_si512(std::data(timestamps) + i);
+    auto const mpid = _mm512_loadu_si512(std::data(mpids) + i);
+    auto const sequence = _mm512_loadu_si512(std::data(sequences) + i);
+    auto const snowflake = _mm512_or_si512(
+        _mm512_or_si512(
+            _mm512_and_si512(
+                _mm512_maskz_slli_epi64(kAllLanes, timestamp,
+                                        LayoutT::kTimestampShift),
+                timestampMask),
+            _mm512_and_si512(_mm512_maskz_slli_epi64(kAllLanes, mpid,
+                                                     LayoutT::kMpidShift),
+                             mpidMask)),
+        _mm512_and_si512(sequence, sequenceMask));
+    _mm512_storeu_si512(std::data(snowflakes) + i, snowflake);
+  }
+  avx2::encode<LayoutT>(timestamps.subspan(i), mpids.subspan(i),
+                        sequences.subspan(i), snowflakes.subspan(i));
+}
+}  // namespace avx512
+#endif
+
+// widest instruction set supported by the running cpu
+enum class Isa { kScalar, kAvx2, kAvx512 };
+
+inline Isa detectIsa() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  static Isa const kIsa = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return Isa::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return Isa::kAvx2;
+    }
+    return Isa::kScalar;
+  }();
+  return kIsa;
+#else
+  return Isa::kScalar;
+#endif
+}
+
+template <typename LayoutT = DefaultLayout>
+inline void decode(std::span<u64 const> snowflakes, std::span<u64> timestamps,
+                   std::span<u64> mpids, std::span<u64> sequences) noexcept {
+  scalar::decode<LayoutT>(snowflakes, timestamps, mpids, sequences);
+}
+
+template <typename LayoutT = DefaultLayout>
+inline void encode(std::span<u64 const> timestamps, std::span<u64 const> mpids,
+                   std::span<u64 const> sequences,
+                   std::span<u64> snowflakes) noexcept {
+  switch (detectIsa()) {
+#if defined(__x86_64__) || defined(__i386__)
+    case Isa::kAvx512:
+      return avx512::encode<LayoutT>(timestamps, mpids, sequences, snowflakes);
+    case Isa::kAvx2:
+      return avx2::encode<LayoutT>(timestamps, mpids, sequences, snowflakes);
+#endif
+    default:
+      return scalar::encode<LayoutT>(timestamps, mpids, sequences, snowflakes);
+  }
+}
+
+}  // namespace bulk
+}  // namespace lf
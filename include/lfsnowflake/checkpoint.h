@@ -0,0 +1,108 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace lf {
+
+// Memory mapped high-water mark of the timestamps issued by a generator.
+// A generator resumed from a checkpoint (BasicGenerator::resume) keeps the
+// stored timestamp ahead of every timestamp it issues, updated on the
+// millisecond reset path only, and never issues a timestamp below the stored
+// one after a restart. The mapping is MAP_SHARED, so stores reach the page
+// cache immediately and survive a crash of the process; call sync() to also
+// survive power loss.
+//
+// The generator's clock must keep its epoch across restarts (ie.
+// lf::clock::System or lf::clock::RealtimeCoarse, not the steady clock)
+class Checkpoint {
+ public:
+  static constexpr std::uint64_t kMagic = 0x4c46534e'4f57464bull;  // LFSNOWFK
+  static constexpr std::uint64_t kVersion = 1ull;
+
+  explicit Checkpoint(char const* path) noexcept {
+    m_Fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_Fd < 0) {
+      return;
+    }
+
+    // a new file is zero filled, an existing one must be a checkpoint
+    struct stat status;
+    if ((::fstat(m_Fd, &status) != 0) ||
+        ((status.st_size != 0) && (status.st_size != sizeof(Header))) ||
+        (::ftruncate(m_Fd, sizeof(Header)) != 0)) {
+      close();
+      return;
+    }
+
+    void* mapping = ::mmap(nullptr, sizeof(Header), PROT_READ | PROT_WRITE,
+                           MAP_SHARED, m_Fd, 0);
+    if (mapping == MAP_FAILED) {
+      close();
+      return;
+    }
+    m_Header = static_cast<Header*>(mapping);
+
+    if (m_Header->magic == 0ull) {
+      m_Header->version = kVersion;
+      m_Header->highWater.store(0ull, std::memory_order_relaxed);
+      m_Header->magic = kMagic;
+    } else if ((m_Header->magic != kMagic) ||
+               (m_Header->version != kVersion)) {
+      close();
+    }
+  }
+
+  ~Checkpoint() noexcept {
+    sync();
+    close();
+  }
+
+  Checkpoint(Checkpoint const&) = delete;
+  Checkpoint& operator=(Checkpoint const&) = delete;
+
+  bool isOpen() const noexcept { return m_Header != nullptr; }
+
+  // timestamp [ticks] that is greater than every timestamp issued so far
+  std::atomic<std::uint64_t>& highWater() noexcept {
+    return m_Header->highWater;
+  }
+
+  // blocks until the high-water mark is written to the file
+  void sync() noexcept {
+    if (m_Header != nullptr) {
+      ::msync(m_Header, sizeof(Header), MS_SYNC);
+    }
+  }
+
+ private:
+  struct Header {
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::atomic<std::uint64_t> highWater;
+  };
+
+  // the atomic is shared through the file, it must not need a lock
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+  void close() noexcept {
+    if (m_Header != nullptr) {
+      ::munmap(m_Header, sizeof(Header));
+      m_Header = nullptr;
+    }
+    if (m_Fd >= 0) {
+      ::close(m_Fd);
+      m_Fd = -1;
+    }
+  }
+
+  int m_Fd = -1;
+  Header* m_Header = nullptr;
+};
+
+}  // namespace lf
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// LFSNOWFLAKE_CLOCK: clock used by lf::utils::millis() and lf::Generator, one
+// of Steady (default), System, MonotonicCoarse, RealtimeCoarse or Tsc
+#ifndef LFSNOWFLAKE_CLOCK
+#define LFSNOWFLAKE_CLOCK Steady
+#endif
+
+namespace lf {
+namespace clock {
+
+// every clock provides a static millis() returning a monotonic millisecond
+// count, the generators only compare timestamps produced by the same clock
+
+// whether the milliseconds of a clock are only meaningful in the process that
+// read them, such clocks cannot back a generator shared between processes
+template <typename Clock>
+inline constexpr bool kIsProcessLocal = false;
+
+// std::chrono::steady_clock, portable but a full clock read on every call
+struct Steady {
+  static std::uint64_t millis() noexcept {
+    std::chrono::milliseconds local_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+    return std::bit_cast<std::uint64_t>(local_time);
+  }
+};
+
+// std::chrono::system_clock, wall time that keeps its epoch across restarts
+struct System {
+  static std::uint64_t millis() noexcept {
+    std::chrono::milliseconds local_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch());
+    return std::bit_cast<std::uint64_t>(local_time);
+  }
+};
+
+#if defined(__linux__)
+// the coarse clocks read the kernel's last tick from the vDSO without touching
+// the hardware counter, their resolution is the kernel tick (1-4 ms), so fewer
+// millisecond edges are observed and the per-tick id ceiling is still 4096
+template <clockid_t kClockId>
+struct PosixClock {
+  static std::uint64_t millis() noexcept {
+    timespec ts;
+    clock_gettime(kClockId, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1'000ull +
+           static_cast<std::uint64_t>(ts.tv_nsec) / 1'000'000ull;
+  }
+};
+
+using MonotonicCoarse = PosixClock<CLOCK_MONOTONIC_COARSE>;
+using RealtimeCoarse = PosixClock<CLOCK_REALTIME_COARSE>;
+#else
+using MonotonicCoarse = Steady;
+using RealtimeCoarse = Steady;
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+// time stamp counter calibrated against the steady clock on first use,
+// cycles are converted to milliseconds with a single multiply-shift,
+// requires an invariant tsc (constant rate and synchronized across cores)
+struct Tsc {
+  struct Calibration {
+    std::uint64_t tscBase;
+    std::uint64_t millisBase;
+    // milliseconds per cycle as a fixed point number with kShift bits
+    std::uint64_t multiplier;
+  };
+
+  static constexpr std::uint64_t kShift = 52ull;
+  static constexpr std::chrono::milliseconds kCalibrationTime{20};
+
+  static Calibration calibrate() noexcept {
+    auto const begin = std::chrono::steady_clock::now();
+    auto const tscBegin = __rdtsc();
+    auto end = begin;
+    while (end - begin < kCalibrationTime) {
+      end = std::chrono::steady_clock::now();
+    }
+    auto const tscEnd = __rdtsc();
+
+    __extension__ using u128 = unsigned __int128;
+    auto const elapsed_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+            .count());
+    auto const cycles = tscEnd - tscBegin;
+    auto const multiplier = static_cast<std::uint64_t>(
+        (u128(elapsed_ns) << kShift) / (u128(cycles) * 1'000'000ull));
+
+    auto const millisBase = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            end.time_since_epoch())
+            .count());
+    return {tscEnd, millisBase, multiplier};
+  }
+
+  static Calibration const& calibration() noexcept {
+    static Calibration const kCalibration = calibrate();
+    return kCalibration;
+  }
+
+  static std::uint64_t millis() noexcept {
+    __extension__ using u128 = unsigned __int128;
+    auto const& calibration = Tsc::calibration();
+    auto const cycles = __rdtsc() - calibration.tscBase;
+    return calibration.millisBase +
+           static_cast<std::uint64_t>(
+               (u128(cycles) * calibration.multiplier) >> kShift);
+  }
+};
+
+// every process calibrates its own base and rate
+template <>
+inline constexpr bool kIsProcessLocal<Tsc> = true;
+#else
+using Tsc = Steady;
+#endif
+
+// background thread publishing the current millisecond of Base, millis() is a
+// plain load instead of a clock read. Unlike the other clocks a Ticker has
+// state, it is owned by the generator using it (lf::BasicGenerator<Ticker<>>)
+// and its thread is started and joined with the generator
+template <typename Base = Steady>
+class Ticker {
+ public:
+  // how often the ticker thread reads Base
+  static constexpr std::chrono::microseconds kTickInterval{50};
+  // readers compare the published millisecond against Base once every
+  // kCheckInterval reads, and fall back to Base while it lags by more than
+  // kStallLimit_ms (ie. the ticker thread is not being scheduled)
+  static constexpr std::uint64_t kCheckInterval = 1'024ull;
+  static constexpr std::uint64_t kStallLimit_ms = 2ull;
+
+  Ticker()
+      : m_Thread([this](std::stop_token stopToken) { run(stopToken); }) {}
+
+  Ticker(Ticker const&) = delete;
+  Ticker& operator=(Ticker const&) = delete;
+
+  std::uint64_t millis() noexcept {
+    if (atm_Stalled.load(std::memory_order_relaxed)) {
+      return Base::millis();
+    }
+
+    auto const published = atm_Millis.load(std::memory_order_acquire);
+
+    thread_local std::uint64_t tl_ReadCount = 0ull;
+    if ((++tl_ReadCount % kCheckInterval) == 0ull) {
+      auto const systemTimestamp = Base::millis();
+      if (systemTimestamp > published + kStallLimit_ms) {
+        atm_Stalled.store(true, std::memory_order_relaxed);
+        return systemTimestamp;
+      }
+    }
+    return published;
+  }
+
+ private:
+  void run(std::stop_token stopToken) noexcept {
+    while (!stopToken.stop_requested()) {
+      // only write on a millisecond edge so readers keep the line shared
+      auto const systemTimestamp = Base::millis();
+      if (systemTimestamp != atm_Millis.load(std::memory_order_relaxed)) {
+        atm_Millis.store(systemTimestamp, std::memory_order_release);
+      }
+      // publish before clearing the stall so readers never see an old value
+      if (atm_Stalled.load(std::memory_order_relaxed)) {
+        atm_Stalled.store(false, std::memory_order_relaxed);
+      }
+      std::this_thread::sleep_for(kTickInterval);
+    }
+  }
+
+  // written at most once per millisecond, read on every millis()
+  alignas(64) std::atomic<std::uint64_t> atm_Millis{Base::millis()};
+  std::atomic<bool> atm_Stalled{false};
+  // declared last so the thread starts after the state above is initialized
+  alignas(64) std::jthread m_Thread;
+};
+
+// published by a thread of the owning process
+template <typename Base>
+inline constexpr bool kIsProcessLocal<Ticker<Base>> = true;
+
+// clock selected at compile time with LFSNOWFLAKE_CLOCK
+using Default = LFSNOWFLAKE_CLOCK;
+
+}  // namespace clock
+}  // namespace lf
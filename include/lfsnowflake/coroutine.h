@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "lockfree.h"
+
+namespace lf {
+
+// awaiter suspended on an exhausted sequence, parked in an EdgeNotifier
+struct ParkedAwaiter {
+  // retries the request, true once the coroutine can be resumed
+  bool (*tryComplete)(ParkedAwaiter& awaiter) noexcept;
+  std::coroutine_handle<> handle;
+};
+
+// Coroutines suspended on an exhausted millisecond. Every executor owns one
+// notifier and calls its poll() from its loop (ie. when idle or on a timer),
+// which retries the parked requests once per millisecond edge, in the order
+// they were parked, and hands the completed coroutines back to the executor.
+// A notifier must not be shared between executors: poll() resumes every
+// coroutine parked on it
+class EdgeNotifier {
+ public:
+  void park(ParkedAwaiter& awaiter) {
+    // counted before it is visible, a concurrent poll() never goes below 0
+    atm_ParkedCount.fetch_add(1ull, std::memory_order_relaxed);
+    std::scoped_lock lock(m_Mutex);
+    m_Parked.push_back(&awaiter);
+  }
+
+  // calls schedule(handle) for every coroutine whose request completed,
+  // returns their number
+  template <typename Schedule>
+  std::size_t poll(Schedule&& schedule) {
+    if (atm_ParkedCount.load(std::memory_order_relaxed) == 0ull) {
+      return 0;
+    }
+    // the sequence is reset at most once per millisecond
+    auto const timestamp = utils::millis();
+    if (atm_LastEdge.exchange(timestamp, std::memory_order_relaxed) ==
+        timestamp) {
+      return 0;
+    }
+
+    std::vector<ParkedAwaiter*> parked;
+    {
+      std::scoped_lock lock(m_Mutex);
+      parked.swap(m_Parked);
+    }
+
+    std::size_t completedCount = 0;
+    auto remaining = std::begin(parked);
+    for (auto* awaiter : parked) {
+      if (awaiter->tryComplete(*awaiter)) {
+        atm_ParkedCount.fetch_sub(1ull, std::memory_order_relaxed);
+        schedule(awaiter->handle);
+        completedCount++;
+      } else {
+        *remaining++ = awaiter;
+      }
+    }
+
+    // keep the parking order, the requests still waiting go first
+    if (remaining != std::begin(parked)) {
+      std::scoped_lock lock(m_Mutex);
+      m_Parked.insert(std::begin(m_Parked), std::begin(parked), remaining);
+    }
+    return completedCount;
+  }
+
+  // resumes the completed coroutines on the calling thread
+  std::size_t poll() {
+    return poll([](std::coroutine_handle<> handle) { handle.resume(); });
+  }
+
+  bool empty() const noexcept {
+    return atm_ParkedCount.load(std::memory_order_relaxed) == 0ull;
+  }
+
+ private:
+  std::mutex m_Mutex;
+  std::vector<ParkedAwaiter*> m_Parked;
+  std::atomic<u64> atm_ParkedCount{0ull};
+  std::atomic<u64> atm_LastEdge{0ull};
+};
+
+// co_await NextId: completes synchronously while the millisecond has
+// sequence numbers left, else parks the coroutine in the notifier
+template <typename GeneratorT = Generator>
+class NextId : ParkedAwaiter {
+ public:
+  NextId(GeneratorT& generator, EdgeNotifier& notifier, u64 mpid) noexcept
+      : ParkedAwaiter{&NextId::complete, {}},
+        m_Generator(generator),
+        m_Notifier(notifier),
+        m_Mpid(mpid) {}
+
+  bool await_ready() noexcept {
+    m_Snowflake = m_Generator.get(m_Mpid);
+    return m_Snowflake != 0ull;
+  }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    this->handle = handle;
+    // may be resumed by another thread before park returns
+    m_Notifier.park(*this);
+  }
+
+  u64 await_resume() const noexcept { return m_Snowflake; }
+
+ private:
+  static bool complete(ParkedAwaiter& awaiter) noexcept {
+    auto& self = static_cast<NextId&>(awaiter);
+    return self.await_ready();
+  }
+
+  GeneratorT& m_Generator;
+  EdgeNotifier& m_Notifier;
+  u64 m_Mpid;
+  u64 m_Snowflake = 0ull;
+};
+
+// co_await NextIds: fills the whole buffer, parking the coroutine whenever a
+// millisecond runs out of sequence numbers, returns the buffer
+template <typename GeneratorT = Generator>
+class NextIds : ParkedAwaiter {
+ public:
+  NextIds(GeneratorT& generator, EdgeNotifier& notifier, u64 mpid,
+          std::span<u64> out) noexcept
+      : ParkedAwaiter{&NextIds::complete, {}},
+        m_Generator(generator),
+        m_Notifier(notifier),
+        m_Mpid(mpid),
+        m_Out(out) {}
+
+  bool await_ready() noexcept {
+    while (m_FilledCount < std::size(m_Out)) {
+      auto const count = m_Generator.getBatch(
+          m_Mpid, static_cast<u64>(std::size(m_Out) - m_FilledCount),
+          m_Out.subspan(m_FilledCount));
+      if (count == 0) {
+        return false;
+      }
+      m_FilledCount += count;
+    }
+    return true;
+  }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    this->handle = handle;
+    m_Notifier.park(*this);
+  }
+
+  std::span<u64> await_resume() const noexcept { return m_Out; }
+
+ private:
+  static bool complete(ParkedAwaiter& awaiter) noexcept {
+    auto& self = static_cast<NextIds&>(awaiter);
+    return self.await_ready();
+  }
+
+  GeneratorT& m_Generator;
+  EdgeNotifier& m_Notifier;
+  u64 m_Mpid;
+  std::span<u64> m_Out;
+  std::size_t m_FilledCount = 0;
+};
+
+// co_await lf::nextId(mpid, notifier): next snowflake of the process-wide
+// generator, notifier is the one of the executor running the coroutine
+inline NextId<> nextId(u64 mpid, EdgeNotifier& notifier) noexcept {
+  return {v4d::g_Generator, notifier, mpid};
+}
+
+// co_await lf::nextIds(mpid, out, notifier): fills out with snowflakes
+inline NextIds<> nextIds(u64 mpid, std::span<u64> out,
+                         EdgeNotifier& notifier) noexcept {
+  return {v4d::g_Generator, notifier, mpid, out};
+}
+
+}  // namespace lf
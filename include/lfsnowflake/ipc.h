@@ -0,0 +1,331 @@
+#pragma once
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lockfree.h"
+
+namespace lf {
+namespace ipc {
+
+// Id server over a UNIX domain stream socket. A request asks for count ids of
+// one mpid, the response is exactly count snowflakes in request order.
+// Clients may pipeline requests, the server answers every request of a read
+// with a single write
+
+// largest count of a single request
+inline constexpr std::uint32_t kMaxBatchSize = 4'096u;
+// most requests a client keeps in flight
+inline constexpr std::size_t kMaxDepth = 64;
+
+struct Request {
+  std::uint32_t mpid;
+  std::uint32_t count;
+};
+
+static_assert(sizeof(Request) == 8);
+
+namespace detail {
+inline bool readAll(int fd, void* data, std::size_t size) noexcept {
+  auto* bytes = static_cast<unsigned char*>(data);
+  while (size != 0) {
+    auto const count = ::read(fd, bytes, size);
+    if (count <= 0) {
+      if ((count < 0) && (errno == EINTR)) {
+        continue;
+      }
+      return false;
+    }
+    bytes += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+
+inline bool writeAll(int fd, void const* data, std::size_t size) noexcept {
+  auto const* bytes = static_cast<unsigned char const*>(data);
+  while (size != 0) {
+    auto const count = ::send(fd, bytes, size, MSG_NOSIGNAL);
+    if (count <= 0) {
+      if ((count < 0) && (errno == EINTR)) {
+        continue;
+      }
+      return false;
+    }
+    bytes += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+
+inline bool makeAddress(char const* path, sockaddr_un& address) noexcept {
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (std::strlen(path) >= sizeof(address.sun_path)) {
+    return false;
+  }
+  std::strcpy(address.sun_path, path);
+  return true;
+}
+}  // namespace detail
+
+// one connection to an id server, not thread safe (use one per thread)
+class Client {
+ public:
+  explicit Client(char const* path) noexcept {
+    sockaddr_un address;
+    if (!detail::makeAddress(path, address)) {
+      return;
+    }
+    m_Fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if ((m_Fd >= 0) &&
+        (::connect(m_Fd, reinterpret_cast<sockaddr const*>(&address),
+                   sizeof(address)) != 0)) {
+      close();
+    }
+  }
+
+  ~Client() noexcept { close(); }
+
+  Client(Client const&) = delete;
+  Client& operator=(Client const&) = delete;
+
+  bool isOpen() const noexcept { return m_Fd >= 0; }
+
+  // one round trip per id, returns 0 if the connection failed
+  u64 get(u64 mpid) noexcept {
+    u64 snowflake = 0ull;
+    getBatch(mpid, std::span<u64>(&snowflake, 1));
+    return snowflake;
+  }
+
+  // one round trip for std::size(out) ids (at most kMaxBatchSize), returns
+  // the number written, all of them or 0 if the connection failed
+  std::size_t getBatch(u64 mpid, std::span<u64> out) noexcept {
+    out = out.first(std::min<std::size_t>(std::size(out), kMaxBatchSize));
+    Request const request{static_cast<std::uint32_t>(mpid),
+                          static_cast<std::uint32_t>(std::size(out))};
+    if (!detail::writeAll(m_Fd, &request, sizeof(request)) ||
+        !detail::readAll(m_Fd, std::data(out), std::size(out) * sizeof(u64))) {
+      close();
+      return 0;
+    }
+    return std::size(out);
+  }
+
+  // fills out with batches of batchSize ids, keeping up to depth requests (at
+  // most kMaxDepth) in flight so the round trips overlap, returns the number
+  // written
+  std::size_t getPipelined(u64 mpid, std::span<u64> out, std::size_t batchSize,
+                           std::size_t depth) noexcept {
+    batchSize = std::clamp<std::size_t>(batchSize, 1, kMaxBatchSize);
+    depth = std::clamp<std::size_t>(depth, 1, kMaxDepth);
+
+    std::size_t requested = 0;
+    std::size_t received = 0;
+    std::array<Request, kMaxDepth> requests;
+    while (received < std::size(out)) {
+      // top up the requests in flight
+      std::size_t requestCount = 0;
+      while ((requested < std::size(out)) &&
+             (requested - received < depth * batchSize)) {
+        auto const count = std::min(batchSize, std::size(out) - requested);
+        requests[requestCount++] = {static_cast<std::uint32_t>(mpid),
+                                    static_cast<std::uint32_t>(count)};
+        requested += count;
+      }
+      if ((requestCount != 0) &&
+          !detail::writeAll(m_Fd, std::data(requests),
+                            requestCount * sizeof(Request))) {
+        close();
+        return received;
+      }
+
+      // wait for the oldest response
+      auto const count = std::min(batchSize, std::size(out) - received);
+      if (!detail::readAll(m_Fd, std::data(out) + received,
+                           count * sizeof(u64))) {
+        close();
+        return received;
+      }
+      received += count;
+    }
+    return received;
+  }
+
+ private:
+  void close() noexcept {
+    if (m_Fd >= 0) {
+      ::close(m_Fd);
+      m_Fd = -1;
+    }
+  }
+
+  int m_Fd = -1;
+};
+
+// serves the ids of a generator, one thread per connection
+class Server {
+ public:
+  // how often blocked threads check for a stop request
+  static constexpr std::chrono::milliseconds kStopPollInterval{100};
+  // requests read (and answered) at once per connection
+  static constexpr std::size_t kReadBatchSize = 64;
+
+  explicit Server(char const* path,
+                  Generator& generator = v4d::g_Generator) noexcept
+      : m_Generator(generator) {
+    sockaddr_un address;
+    if (!detail::makeAddress(path, address)) {
+      return;
+    }
+    m_Fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_Fd < 0) {
+      return;
+    }
+    ::unlink(path);
+    if ((::bind(m_Fd, reinterpret_cast<sockaddr const*>(&address),
+                sizeof(address)) != 0) ||
+        (::listen(m_Fd, SOMAXCONN) != 0)) {
+      ::close(m_Fd);
+      m_Fd = -1;
+      return;
+    }
+    m_Path = address.sun_path;
+  }
+
+  ~Server() noexcept {
+    if (m_Fd >= 0) {
+      ::close(m_Fd);
+      ::unlink(m_Path.c_str());
+    }
+  }
+
+  Server(Server const&) = delete;
+  Server& operator=(Server const&) = delete;
+
+  bool isOpen() const noexcept { return m_Fd >= 0; }
+
+  // accepts connections until a stop is requested, then joins them
+  void run(std::stop_token stopToken) {
+    std::vector<Connection> connections;
+    while (!stopToken.stop_requested()) {
+      // join the threads of closed connections
+      std::erase_if(connections, [](Connection const& connection) {
+        return connection.atm_Done->load(std::memory_order_acquire);
+      });
+
+      if (!waitReadable(m_Fd)) {
+        continue;
+      }
+      auto const fd = ::accept4(m_Fd, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd >= 0) {
+        auto done = std::make_unique<std::atomic<bool>>(false);
+        auto* isDone = done.get();
+        connections.push_back(
+            {std::move(done),
+             std::jthread([this, fd, isDone](
+                              std::stop_token connectionStopToken) {
+               serve(fd, connectionStopToken);
+               ::close(fd);
+               isDone->store(true, std::memory_order_release);
+             })});
+      }
+    }
+  }
+
+ private:
+  struct Connection {
+    // set by the thread when it is about to exit
+    std::unique_ptr<std::atomic<bool>> atm_Done;
+    // declared last: destroyed (stopped and joined) before the flag
+    std::jthread thread;
+  };
+
+  static bool waitReadable(int fd) noexcept {
+    pollfd poll{fd, POLLIN, 0};
+    return ::poll(&poll, 1, static_cast<int>(kStopPollInterval.count())) > 0;
+  }
+
+  void serve(int fd, std::stop_token stopToken) {
+    std::vector<Request> requests(kReadBatchSize);
+    std::vector<u64> snowflakes;
+    std::size_t pendingBytes = 0;
+    auto* buffer = reinterpret_cast<unsigned char*>(std::data(requests));
+
+    while (!stopToken.stop_requested()) {
+      if (!waitReadable(fd)) {
+        continue;
+      }
+      auto const count =
+          ::read(fd, buffer + pendingBytes,
+                 kReadBatchSize * sizeof(Request) - pendingBytes);
+      if (count <= 0) {
+        if ((count < 0) && (errno == EINTR)) {
+          continue;
+        }
+        return;
+      }
+      pendingBytes += static_cast<std::size_t>(count);
+
+      // answer every complete request with a single write
+      auto const requestCount = pendingBytes / sizeof(Request);
+      snowflakes.clear();
+      for (std::size_t i = 0; i < requestCount; i++) {
+        auto const& request = requests[i];
+        if (request.count > kMaxBatchSize) {
+          return;
+        }
+        generate(request, snowflakes);
+      }
+      if (!detail::writeAll(fd, std::data(snowflakes),
+                            std::size(snowflakes) * sizeof(u64))) {
+        return;
+      }
+
+      // keep a partial request for the next read
+      auto const consumedBytes = requestCount * sizeof(Request);
+      std::memmove(buffer, buffer + consumedBytes,
+                   pendingBytes - consumedBytes);
+      pendingBytes -= consumedBytes;
+    }
+  }
+
+  // appends request.count ids, parks on an exhausted millisecond
+  void generate(Request const& request, std::vector<u64>& snowflakes) {
+    auto offset = std::size(snowflakes);
+    snowflakes.resize(offset + request.count);
+    while (offset < std::size(snowflakes)) {
+      auto const count = m_Generator.getBatch(
+          request.mpid, static_cast<u64>(std::size(snowflakes) - offset),
+          std::span<u64>(snowflakes).subspan(offset));
+      if (count == 0) {
+        snowflakes[offset++] = m_Generator.getBlocking(request.mpid);
+      }
+      offset += count;
+    }
+  }
+
+  Generator& m_Generator;
+  int m_Fd = -1;
+  std::string m_Path;
+};
+
+}  // namespace ipc
+}  // namespace lf
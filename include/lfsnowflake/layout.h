@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+namespace lf {
+
+using u64 = std::uint64_t;
+
+// Bit layout of a snowflake, all conversions are constexpr shifts and masks.
+// OUTPUT FORMAT - snowflake (msb first, remaining top bits are unused):
+// |--TimestampBits timestamp--|--MpidBits MPID--|--SequenceBits sequence--|
+// INPUT FORMAT - compact sequence (shared atomic of the generators):
+// |--------------timestamp [ticks]--------------|--SequenceBits sequence--|
+// The timestamp is counted in TickUnit (>= 1 ms) since Epoch, where Epoch is
+// in milliseconds of the generator's clock
+template <u64 TimestampBits, u64 MpidBits, u64 SequenceBits, u64 Epoch = 0ull,
+          typename TickUnit = std::chrono::milliseconds>
+struct Layout {
+  // MpidBits may be 0 for layouts that keep the MPID elsewhere (lf::wide)
+  static_assert(TimestampBits > 0ull && SequenceBits > 0ull,
+                "the timestamp and the sequence need at least one bit");
+  static_assert(TimestampBits + MpidBits + SequenceBits <= 63ull,
+                "snowflakes must fit into 63 bits (top bit is unused)");
+  static_assert(std::ratio_greater_equal_v<typename TickUnit::period,
+                                           std::milli> &&
+                    (TickUnit::period::num * 1'000) % TickUnit::period::den ==
+                        0,
+                "tick unit must be a whole number of milliseconds");
+
+  static constexpr u64 kTimestampBits = TimestampBits;
+  static constexpr u64 kMpidBits = MpidBits;
+  static constexpr u64 kSequenceBits = SequenceBits;
+  static constexpr u64 kEpoch = Epoch;
+  static constexpr u64 kMillisPerTick = static_cast<u64>(
+      (TickUnit::period::num * 1'000) / TickUnit::period::den);
+
+  static constexpr u64 kSequenceShift = 0ull;
+  static constexpr u64 kMpidShift = kSequenceBits;
+  static constexpr u64 kTimestampShift = kSequenceBits + kMpidBits;
+
+  static constexpr u64 kSequenceMask = ((1ull << kSequenceBits) - 1ull)
+                                       << kSequenceShift;
+  static constexpr u64 kMpidMask = ((1ull << kMpidBits) - 1ull) << kMpidShift;
+  static constexpr u64 kTimestampMask = ((1ull << kTimestampBits) - 1ull)
+                                        << kTimestampShift;
+
+  // number of sequence numbers available per tick
+  static constexpr u64 kSequenceCount = 1ull << kSequenceBits;
+
+  static_assert((kSequenceMask bitand kMpidMask) == 0ull);
+  static_assert((kMpidMask bitand kTimestampMask) == 0ull);
+
+  // clock milliseconds -> ticks since the epoch
+  static constexpr u64 toTicks(u64 millis) noexcept {
+    return (millis - kEpoch) / kMillisPerTick;
+  }
+
+  // compact sequence -> snowflake, timestamps past kTimestampBits wrap around
+  static constexpr u64 encode(u64 mpid, u64 compactSequence) noexcept {
+    return (((compactSequence >> kSequenceBits) << kTimestampShift) bitand
+            kTimestampMask) bitor
+           ((mpid << kMpidShift) bitand kMpidMask) bitor
+           (compactSequence bitand kSequenceMask);
+  }
+
+  static constexpr u64 make(u64 timestamp, u64 mpid, u64 sequence) noexcept {
+    return encode(mpid, (timestamp << kSequenceBits) bitor
+                            (sequence bitand kSequenceMask));
+  }
+
+  static constexpr u64 getTimestamp(u64 snowflake) noexcept {
+    return (snowflake bitand kTimestampMask) >> kTimestampShift;
+  }
+
+  static constexpr u64 getMpid(u64 snowflake) noexcept {
+    return (snowflake bitand kMpidMask) >> kMpidShift;
+  }
+
+  static constexpr u64 getSequence(u64 snowflake) noexcept {
+    return (snowflake bitand kSequenceMask) >> kSequenceShift;
+  }
+};
+
+// Twitter's layout: 41 bit timestamp [ms], 10 bit MPID, 12 bit sequence
+using DefaultLayout = Layout<41ull, 10ull, 12ull>;
+
+static_assert(DefaultLayout::make(1ull, 2ull, 3ull) ==
+              ((1ull << 22) bitor (2ull << 12) bitor 3ull));
+static_assert(DefaultLayout::getMpid(DefaultLayout::make(7ull, 1'023ull,
+                                                         4'095ull)) ==
+              1'023ull);
+
+}  // namespace lf
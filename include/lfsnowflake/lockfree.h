@@ -1,119 +1,582 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <span>
+#include <thread>
 
-namespace lf {
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "clock.h"
+#include "layout.h"
+#include "stats.h"
 
-#ifndef MAKE_SNOWFLAKE_FAST
-// INPUT FORMAT - sequence number:
-// |---------------52 bit timestamp---------------|--12 bit sequence number--|
-// |                                              x                          |
-// |-----------------------------64 bit sequence-----------------------------|
-// INPUT FORMAT - mpid:
-// |----------5 bit machine id----------|----------5 bit process id----------|
-// |                                    x                                    |
-// |-----------------------------10 bit mpid---------------------------------|
-// OUTPUT FORMAT - snowflake:
-// |--1 bit--|--41 bit timestamp--|--10 bit MPID--|--12 bit sequence number--|
-// |                              x               x                          |
-// |-----------------------------64 bit snowflake----------------------------|
-#define MAKE_SNOWFLAKE_FAST(mpid, sequence)                                    \
-  (((sequence) bitand utils::kTimestampMask) << 22) bitor ((mpid) << 10) bitor \
-      (((sequence) bitand utils::kSequenceNumberMask))
+// LFSNOWFLAKE_SHARDED: make the sharded generator (v6a) back lf::get,
+// lf::reserve, lf::getBatch and lf::getBlocking
+// LFSNOWFLAKE_SHARD_BITS: number of high sequence bits used as the shard index
+#ifndef LFSNOWFLAKE_SHARD_BITS
+#define LFSNOWFLAKE_SHARD_BITS 2
 #endif
 
+namespace lf {
+
 using u64 = std::uint64_t;
 
 namespace utils {
 
-inline std::uint64_t millis() noexcept {
-  std::chrono::milliseconds local_time =
-      std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::steady_clock::now().time_since_epoch());
-  return std::bit_cast<std::uint64_t>(local_time);
-}
+inline std::uint64_t millis() noexcept { return clock::Default::millis(); }
 
 inline std::uint64_t epoch() noexcept {
   // epoch: Jan 1st, 2025, 00:00:00 UTC
   return 1'735'711'200'000ull;
 }
 
-inline constexpr u64 kSequenceNumberMask = (4'095ull << 0);
-inline constexpr u64 kMpidMask = (1'023ull << 12);
-inline constexpr u64 kTimestampMask = (2'199'023'255'551ull << 22);
+inline constexpr u64 kSequenceNumberMask = DefaultLayout::kSequenceMask;
+inline constexpr u64 kMpidMask = DefaultLayout::kMpidMask;
+inline constexpr u64 kTimestampMask = DefaultLayout::kTimestampMask;
+// number of sequence numbers available per millisecond
+inline constexpr u64 kSequenceCount = DefaultLayout::kSequenceCount;
 
 static_assert((kSequenceNumberMask xor kMpidMask xor kTimestampMask) !=
               18'446'744'073'709'551'615ull);
 static_assert((kSequenceNumberMask xor kMpidMask xor kTimestampMask) ==
               9'223'372'036'854'775'807ull);
 
+// cpu hint for spin loops
+inline void pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#endif
+}
+
 inline u64 getTimestamp(u64 snowflake) {
   return (snowflake bitand kTimestampMask) >> 22;
 }
 
 inline u64 getMpid(u64 snowflake) {
-  return (snowflake bitand kMpidMask) > 12;
+  return (snowflake bitand kMpidMask) >> 12;
 }
 
 inline u64 getSequence(u64 snowflake) {
   return (snowflake bitand kSequenceNumberMask) >> 0;
 }
 
+// sharded generator (v6a): the 12 bit sequence number is split into
+// |--shard bits--|--per shard sequence number--|
+inline constexpr u64 kShardBits = LFSNOWFLAKE_SHARD_BITS;
+inline constexpr u64 kShardSequenceBits =
+    DefaultLayout::kSequenceBits - kShardBits;
+inline constexpr u64 kShardSequenceMask = (1ull << kShardSequenceBits) - 1ull;
+
+static_assert(kShardBits < DefaultLayout::kSequenceBits,
+              "at least one sequence bit per shard");
+
+inline u64 getShard(u64 snowflake) {
+  return getSequence(snowflake) >> kShardSequenceBits;
+}
+
+inline u64 getShardSequence(u64 snowflake) {
+  return getSequence(snowflake) bitand kShardSequenceMask;
+}
+
 }  // namespace utils
 
-inline namespace v4d {
-inline std::atomic<u64> atm_CompactSequence(0ull);
+// a run of sequence numbers claimed with a single atomic operation, all
+// values in [sequence, sequence + count) share the same timestamp
+struct Reservation {
+  u64 sequence;
+  u64 count;
+};
+
+// an independent snowflake generator, each instance owns its compact sequence
+// on its own cache line so generators never false-share with each other,
+// Clock is one of the lf::clock sources (see clock.h) and LayoutT an
+// lf::Layout (see layout.h) that sets the field widths, epoch and tick unit
+template <typename Clock = clock::Default, typename LayoutT = DefaultLayout>
+class alignas(64) BasicGenerator {
+ public:
+  constexpr BasicGenerator() noexcept = default;
+
+  BasicGenerator(BasicGenerator const&) = delete;
+  BasicGenerator& operator=(BasicGenerator const&) = delete;
+
+  u64 get(u64 mpid) noexcept {
+    // v4a Goal: previous iterations did not reset the sequence if the
+    // millisecond edge had been triggered
+
+    // sequence is stored in the following format:
+    // |-------- timestamp [ticks] ----|-- kSequenceBits id sequence ----|
+
+    // acquire global sequence after any writes (includes id and timestamp)
+    auto sequence = atm_CompactSequence.load(std::memory_order_acquire);
+    auto const sequenceTimestamp = sequence >> LayoutT::kSequenceBits;
+    // acquire most recent system time
+    auto const systemTimestamp = LayoutT::toTicks(m_Clock.millis());
+
+    /* Sequence's timestamp != system timestamp, one of the following has
+       occured:
+       1. Overflow of max sequence (sequence timestamp > system timestamp)
+       2. System timestamp has changed (sequence timestamp < system timestamp)
+    */
+
+    /* CANNOT BE OPTIMIZED, MUST WAIT UNTIL NEXT MILLISECOND */
+    // case 1. overflow of max sequence (unlikely as thread count grows)
+    // the sequence timestamp is now greater than the system timestamp
+    // (plus the burst credit), we should wait until the next millisecond
+    // (just return from function)
+    if (isExhausted(sequenceTimestamp, systemTimestamp)) {
+      stats::count(stats::kExhausted);
+      return 0ull;
+    }
+
+    // case 2. start of new millisecond, attempt to reset the sequence to 0
+    if (sequenceTimestamp < systemTimestamp) {
+      auto const resetSequence = (systemTimestamp << LayoutT::kSequenceBits);
+      advanceHighWater(systemTimestamp);
+      // attempt to reset sequence, else, spillover into case 3.
+      // https://en.cppreference.com/w/cpp/atomic/atomic/compare_exchange
+      if (atm_CompactSequence.compare_exchange_strong(
+              sequence, resetSequence + 1ull, std::memory_order_acq_rel,
+              std::memory_order_relaxed)) {
+        stats::count(stats::kResetsWon);
+        stats::count(stats::kIssued);
+        // make snowflake of sequence number = 0
+        return LayoutT::encode(mpid, resetSequence);
+      }
+      stats::count(stats::kCasFailures);
+    }
+
+    // // case 3. sequence timestamp is the same as the sequence timestamp
+    // https://en.cppreference.com/w/cpp/atomic/atomic/fetch_add
+    sequence = atm_CompactSequence.fetch_add(1ull, std::memory_order_acq_rel);
+    stats::count(stats::kIssued);
+    onIssued(sequence, systemTimestamp, 1ull);
+    return LayoutT::encode(mpid, sequence);
+  }
+
+  Reservation reserve(u64 n) noexcept {
+    // same cases as get(), but the sequence is advanced by n instead of 1
+    auto sequence = atm_CompactSequence.load(std::memory_order_acquire);
+    auto const sequenceTimestamp = sequence >> LayoutT::kSequenceBits;
+    auto const systemTimestamp = LayoutT::toTicks(m_Clock.millis());
+
+    // never claim more than a single millisecond can hold
+    n = std::min<u64>(n, LayoutT::kSequenceCount);
+    if (n == 0ull) {
+      return {0ull, 0ull};
+    }
+
+    // case 1. sequence exhausted, must wait until next millisecond
+    if (isExhausted(sequenceTimestamp, systemTimestamp)) {
+      stats::count(stats::kExhausted);
+      return {0ull, 0ull};
+    }
+
+    // case 2. start of new millisecond, attempt to claim [0, n)
+    if (sequenceTimestamp < systemTimestamp) {
+      auto const resetSequence = (systemTimestamp << LayoutT::kSequenceBits);
+      advanceHighWater(systemTimestamp);
+      if (atm_CompactSequence.compare_exchange_strong(
+              sequence, resetSequence + n, std::memory_order_acq_rel,
+              std::memory_order_relaxed)) {
+        stats::count(stats::kResetsWon);
+        stats::count(stats::kIssued, n);
+        return {resetSequence, n};
+      }
+      stats::count(stats::kCasFailures);
+    }
+
+    // case 3. clip the request to what is left of the current millisecond
+    // before claiming, other threads may still race us past the edge
+    auto const remaining =
+        LayoutT::kSequenceCount - (sequence bitand LayoutT::kSequenceMask);
+    n = std::min<u64>(n, remaining);
+
+    sequence = atm_CompactSequence.fetch_add(n, std::memory_order_acq_rel);
+
+    // clip again against the sequence we actually received, anything past the
+    // sequence edge would carry into the next timestamp and is discarded.
+    // At least one id is left (the masked sequence is below kSequenceCount),
+    // an empty reservation only comes from case 1
+    auto const available =
+        LayoutT::kSequenceCount - (sequence bitand LayoutT::kSequenceMask);
+    auto const count = std::min<u64>(n, available);
+    stats::count(stats::kIssued, count);
+    onIssued(sequence, systemTimestamp, count);
+    return {sequence, count};
+  }
+
+  // fills out with up to n snowflakes, returns the number written
+  // (0 if the sequence is exhausted for this millisecond, same as get())
+  std::size_t getBatch(u64 mpid, u64 n, std::span<u64> out) noexcept {
+    auto const reservation =
+        reserve(std::min<u64>(n, static_cast<u64>(std::size(out))));
+
+    auto const base = LayoutT::encode(mpid, reservation.sequence);
+    for (auto i = 0ull; i < reservation.count; i++) {
+      out[i] = base + i;
+    }
+    return static_cast<std::size_t>(reservation.count);
+  }
+
+  // ticks the persisted high-water mark is kept ahead of issued timestamps,
+  // it is rewritten once the clock gets within half of this distance
+  static constexpr u64 kHighWaterLead = 16ull;
+
+  // persist issued timestamps in highWater (ie. lf::Checkpoint::highWater())
+  // and never issue a timestamp below its current value, so a restarted
+  // process can generate immediately without duplicating earlier ids: the
+  // ids of the stored tick are issued right away even while it is ahead of
+  // the clock (at most kHighWaterLead ticks), later ticks wait for the clock.
+  // Must be called before the generator is shared between threads
+  void resume(std::atomic<u64>& highWater) noexcept {
+    m_HighWater = &highWater;
+    auto const resumeTimestamp = highWater.load(std::memory_order_acquire);
+    m_ResumeTimestamp = resumeTimestamp;
+    // ids of resumeTimestamp may be issued without a reset, so move the mark
+    // past it before the sequence is allowed to reach it
+    advanceHighWater(resumeTimestamp);
+    auto const resumeSequence = resumeTimestamp << LayoutT::kSequenceBits;
+    if (atm_CompactSequence.load(std::memory_order_relaxed) < resumeSequence) {
+      atm_CompactSequence.store(resumeSequence, std::memory_order_release);
+    }
+  }
+
+  // lets the sequence run up to ticks ahead of the clock during bursts, once
+  // a tick is exhausted the next ones are borrowed instead of returning 0,
+  // so issued timestamps stay within ticks (+1 for carries) of the clock.
+  // Must be called before the generator is shared between threads
+  void setBurstCredit(u64 ticks) noexcept { m_BurstCredit = ticks; }
+
+  // ticks the sequence currently runs ahead of the clock
+  u64 ahead() noexcept {
+    auto const sequenceTimestamp =
+        atm_CompactSequence.load(std::memory_order_relaxed) >>
+        LayoutT::kSequenceBits;
+    auto const systemTimestamp = LayoutT::toTicks(m_Clock.millis());
+    return (sequenceTimestamp > systemTimestamp)
+               ? sequenceTimestamp - systemTimestamp
+               : 0ull;
+  }
+
+  // number of failed get() calls spent spinning before parking the thread
+  static constexpr u64 kSpinCount = 64ull;
+  // how often the thread woken on the millisecond edge polls the clock
+  static constexpr std::chrono::microseconds kEdgePollInterval{50};
+
+  // same as get(), but never returns 0. When the sequence is exhausted the
+  // caller spins briefly, then parks until the millisecond rolls over
+  u64 getBlocking(u64 mpid) noexcept {
+    for (auto spinCount = 0ull;; spinCount++) {
+      if (auto const snowflake = get(mpid); snowflake != 0ull) {
+        return snowflake;
+      }
+
+      if (spinCount < kSpinCount) {
+        utils::pause();
+      } else {
+        waitForEdge();
+      }
+    }
+  }
+
+ private:
+  // case 1 of get(): the sequence ran past the clock (plus the burst credit),
+  // the resumed tick was never issued and is not waited for
+  bool isExhausted(u64 sequenceTimestamp, u64 systemTimestamp) const noexcept {
+    return (sequenceTimestamp > systemTimestamp + m_BurstCredit) &&
+           (sequenceTimestamp > m_ResumeTimestamp);
+  }
+
+  // bookkeeping for ids claimed on the fetch_add path, the first id of a tick
+  // reached by a carry moves the high-water mark (a reset moves it before it
+  // is published), which keeps it ahead of borrowed ticks too
+  void onIssued(u64 sequence, u64 systemTimestamp, u64 count) noexcept {
+    auto const sequenceTimestamp = sequence >> LayoutT::kSequenceBits;
+    if ((sequence bitand LayoutT::kSequenceMask) == 0ull) {
+      advanceHighWater(sequenceTimestamp);
+    }
+    if (sequenceTimestamp > systemTimestamp) {
+      stats::count(stats::kBorrowed, count);
+      stats::observeMax(stats::kMaxAhead, sequenceTimestamp - systemTimestamp);
+    }
+  }
+
+  // called before a reset to timestamp is published, so the high-water mark
+  // is always ahead of every issued timestamp (including sequence carries)
+  void advanceHighWater(u64 timestamp) noexcept {
+    if (m_HighWater == nullptr) {
+      return;
+    }
+    auto highWater = m_HighWater->load(std::memory_order_acquire);
+    while (highWater <= timestamp + (kHighWaterLead / 2ull)) {
+      if (m_HighWater->compare_exchange_weak(
+              highWater, timestamp + kHighWaterLead, std::memory_order_acq_rel,
+              std::memory_order_acquire)) {
+        return;
+      }
+    }
+  }
+
+  // parks the caller until the exhausted millisecond has passed, a single
+  // thread polls the clock and wakes every other waiter with one notify_all
+  void waitForEdge() noexcept {
+    // read the edge count before anything else so a wake up between here and
+    // wait() is never lost (wait returns immediately if it has changed)
+    auto const edge = atm_EdgeCount.load();
+    // ids become available once the clock reaches the sequence's timestamp
+    auto const exhaustedTimestamp =
+        atm_CompactSequence.load(std::memory_order_relaxed) >>
+        LayoutT::kSequenceBits;
+    if (LayoutT::toTicks(m_Clock.millis()) + m_BurstCredit >=
+        exhaustedTimestamp) {
+      return;
+    }
+
+    if (atm_EdgeWaiting.exchange(true)) {
+      // another thread is already waiting for the edge
+      atm_EdgeCount.wait(edge);
+      return;
+    }
+
+    while (LayoutT::toTicks(m_Clock.millis()) + m_BurstCredit <
+           exhaustedTimestamp) {
+      std::this_thread::sleep_for(kEdgePollInterval);
+    }
+    atm_EdgeWaiting.store(false);
+    atm_EdgeCount.fetch_add(1ull);
+    atm_EdgeCount.notify_all();
+  }
+
+  std::atomic<u64> atm_CompactSequence{0ull};
+  // stateless for every clock except lf::clock::Ticker
+  [[no_unique_address]] Clock m_Clock;
+  // optional persisted high-water mark, only read on the reset path
+  std::atomic<u64>* m_HighWater = nullptr;
+  // ticks the sequence may run ahead of the clock
+  u64 m_BurstCredit = 0ull;
+  // tick restored by resume(), issued without waiting for the clock
+  u64 m_ResumeTimestamp = 0ull;
+
+  // only touched once the sequence is exhausted, kept off the hot line
+  alignas(64) std::atomic<u64> atm_EdgeCount{0ull};
+  std::atomic<bool> atm_EdgeWaiting{false};
+};
+
+using Generator = BasicGenerator<>;
+
+static_assert(alignof(Generator) == 64);
+static_assert(sizeof(Generator) == 128);
+
+#ifndef LFSNOWFLAKE_SHARDED
+inline
+#endif
+namespace v4d {
+// process-wide generator backing the free functions
+inline Generator g_Generator;
+
+inline u64 get(u64 mpid) noexcept { return g_Generator.get(mpid); }
+
+inline Reservation reserve(u64 n) noexcept { return g_Generator.reserve(n); }
+
+inline std::size_t getBatch(u64 mpid, u64 n, std::span<u64> out) noexcept {
+  return g_Generator.getBatch(mpid, n, out);
+}
+
+inline u64 getBlocking(u64 mpid) noexcept {
+  return g_Generator.getBlocking(mpid);
+}
+
+}  // namespace v4d
+
+namespace v5a {
+// number of sequence numbers a thread leases from the shared sequence at once
+inline constexpr u64 kLeaseSize = 64ull;
+
+// compact sequences [sequence, end) owned by this thread
+struct Lease {
+  u64 sequence = 0ull;
+  u64 end = 0ull;
+};
+
+inline thread_local Lease tl_Lease;
+
+inline u64 get(u64 mpid) noexcept {
+  // v5a Goal: touch the shared sequence once per lease instead of once per id
+
+  auto& lease = tl_Lease;
+  auto const systemTimestamp = utils::millis();
+
+  // the lease is thrown away once it is used up or the millisecond edge has
+  // been crossed, so the sequence still resets on each new millisecond
+  if ((lease.sequence == lease.end) ||
+      ((lease.sequence >> DefaultLayout::kSequenceBits) != systemTimestamp)) {
+    auto const reservation = v4d::reserve(kLeaseSize);
+    if (reservation.count == 0ull) {
+      return 0ull;
+    }
+    lease = {reservation.sequence, reservation.sequence + reservation.count};
+  }
+
+  auto const sequence = lease.sequence++;
+  return DefaultLayout::encode(mpid, sequence);
+}
+
+}  // namespace v5a
+
+#ifdef LFSNOWFLAKE_SHARDED
+inline
+#endif
+namespace v6a {
+inline constexpr u64 kShardCount = 1ull << utils::kShardBits;
+
+// each shard owns its compact sequence on a separate cache line
+struct alignas(64) Shard {
+  std::atomic<u64> atm_CompactSequence{0ull};
+};
+
+inline Shard g_Shards[kShardCount];
+
+// threads are assigned to shards round robin on their first call
+inline std::atomic<u64> atm_NextShard(0ull);
+inline thread_local u64 const tl_ShardIndex =
+    atm_NextShard.fetch_add(1ull, std::memory_order_relaxed) % kShardCount;
+
+inline constexpr u64 kShardSequenceCount = utils::kShardSequenceMask + 1ull;
+
+// widens a shard sequence back into the v4d compact format, with the shard as
+// the top bits of the sequence number
+inline u64 widen(u64 shardIndex, u64 sequence) noexcept {
+  return ((sequence >> utils::kShardSequenceBits)
+          << DefaultLayout::kSequenceBits) bitor
+         (shardIndex << utils::kShardSequenceBits) bitor
+         (sequence bitand utils::kShardSequenceMask);
+}
 
 inline u64 get(u64 mpid) noexcept {
-  // v4a Goal: previous iterations did not reset the sequence if the millisecond
-  // edge had been triggered
+  // v6a Goal: threads on different shards never touch the same atomic
+
+  // sequence is stored in the following format (per shard):
+  // |-------- 52+ bit timestamp [ms] ----|-- 12 - shard bits id sequence --|
 
-  // sequence is stored in the following format:
-  // |-------- 52 bit timestamp [ms] ----|-- 12 bit id sequence ----|
+  auto const shardIndex = tl_ShardIndex;
+  auto& atm_CompactSequence = g_Shards[shardIndex].atm_CompactSequence;
 
-  // acquire global sequence after any writes (includes id and timestamp)
   auto sequence = atm_CompactSequence.load(std::memory_order_acquire);
-  auto const sequenceTimestamp = sequence >> 12;
-  // acquire most recent system time
+  auto const sequenceTimestamp = sequence >> utils::kShardSequenceBits;
   auto const systemTimestamp = utils::millis();
 
-  /* Sequence's timestamp != system timestamp, one of the following has occured:
-     1. Overflow of 12 bit max sequence (sequence timestamp > system timestamp)
-     2. System timestamp has changed (sequence timestamp < system timestamp)
-  */
-
-  /* CANNOT BE OPTIMIZED, MUST WAIT UNTIL NEXT MILLISECOND */
-  // case 1. overflow of 12 bit max sequence (unlikely as thread count grows)
-  // the sequence timestamp is now greater than the system timestamp
-  // we should wait until the next millisecond (just return from function)
+  // same cases as v4d, only the width of the sequence number differs
+  // case 1. overflow of the shard's sequence, wait until next millisecond
   if (sequenceTimestamp > systemTimestamp) {
+    stats::count(stats::kExhausted);
     return 0ull;
   }
 
   // case 2. start of new millisecond, attempt to reset the sequence to 0
   if (sequenceTimestamp < systemTimestamp) {
-    auto const resetSequence = (systemTimestamp << 12);
-    // attempt to reset sequence, else, spillover into case 3.
-    // https://en.cppreference.com/w/cpp/atomic/atomic/compare_exchange
+    auto const resetSequence = (systemTimestamp << utils::kShardSequenceBits);
     if (atm_CompactSequence.compare_exchange_strong(
             sequence, resetSequence + 1ull, std::memory_order_acq_rel,
             std::memory_order_relaxed)) {
-      // make snowflake of sequence number = 0
-      return MAKE_SNOWFLAKE_FAST(mpid, resetSequence);
+      stats::count(stats::kResetsWon);
+      stats::count(stats::kIssued);
+      // make snowflake of shard sequence number = 0
+      return DefaultLayout::encode(mpid, widen(shardIndex, resetSequence));
     }
+    stats::count(stats::kCasFailures);
   }
 
-  // // case 3. sequence timestamp is the same as the sequence timestamp
-  // https://en.cppreference.com/w/cpp/atomic/atomic/fetch_add
+  // case 3. sequence timestamp is the same as the system timestamp
   sequence = atm_CompactSequence.fetch_add(1ull, std::memory_order_acq_rel);
-  return MAKE_SNOWFLAKE_FAST(mpid, sequence);
+  stats::count(stats::kIssued);
+
+  return DefaultLayout::encode(mpid, widen(shardIndex, sequence));
 }
 
-}  // namespace v4d
+// same as lf::BasicGenerator::reserve on the thread's shard, the reservation
+// is in the widened (v4d) compact format and never leaves the shard
+inline Reservation reserve(u64 n) noexcept {
+  auto const shardIndex = tl_ShardIndex;
+  auto& atm_CompactSequence = g_Shards[shardIndex].atm_CompactSequence;
+
+  auto sequence = atm_CompactSequence.load(std::memory_order_acquire);
+  auto const sequenceTimestamp = sequence >> utils::kShardSequenceBits;
+  auto const systemTimestamp = utils::millis();
+
+  // never claim more than a shard holds per millisecond
+  n = std::min<u64>(n, kShardSequenceCount);
+  if (n == 0ull) {
+    return {0ull, 0ull};
+  }
+
+  // case 1. overflow of the shard's sequence, wait until next millisecond
+  if (sequenceTimestamp > systemTimestamp) {
+    stats::count(stats::kExhausted);
+    return {0ull, 0ull};
+  }
+
+  // case 2. start of new millisecond, attempt to claim [0, n)
+  if (sequenceTimestamp < systemTimestamp) {
+    auto const resetSequence = (systemTimestamp << utils::kShardSequenceBits);
+    if (atm_CompactSequence.compare_exchange_strong(
+            sequence, resetSequence + n, std::memory_order_acq_rel,
+            std::memory_order_relaxed)) {
+      stats::count(stats::kResetsWon);
+      stats::count(stats::kIssued, n);
+      return {widen(shardIndex, resetSequence), n};
+    }
+    stats::count(stats::kCasFailures);
+  }
+
+  // case 3. clip to what is left of the shard, before and after claiming
+  auto const remaining =
+      kShardSequenceCount - (sequence bitand utils::kShardSequenceMask);
+  n = std::min<u64>(n, remaining);
+
+  sequence = atm_CompactSequence.fetch_add(n, std::memory_order_acq_rel);
+
+  auto const available =
+      kShardSequenceCount - (sequence bitand utils::kShardSequenceMask);
+  auto const count = std::min<u64>(n, available);
+  stats::count(stats::kIssued, count);
+  return {widen(shardIndex, sequence), count};
+}
+
+// fills out with up to n snowflakes, returns the number written
+inline std::size_t getBatch(u64 mpid, u64 n, std::span<u64> out) noexcept {
+  auto const reservation =
+      reserve(std::min<u64>(n, static_cast<u64>(std::size(out))));
+
+  auto const base = DefaultLayout::encode(mpid, reservation.sequence);
+  for (auto i = 0ull; i < reservation.count; i++) {
+    out[i] = base + i;
+  }
+  return static_cast<std::size_t>(reservation.count);
+}
+
+// same as get(), but never returns 0. The shards keep no waiter state, so
+// after spinning the caller sleeps until the shard's millisecond has passed
+inline u64 getBlocking(u64 mpid) noexcept {
+  for (auto spinCount = 0ull;; spinCount++) {
+    if (auto const snowflake = get(mpid); snowflake != 0ull) {
+      return snowflake;
+    }
+
+    if (spinCount < Generator::kSpinCount) {
+      utils::pause();
+    } else {
+      std::this_thread::sleep_for(Generator::kEdgePollInterval);
+    }
+  }
+}
+
+}  // namespace v6a
 
-#ifdef MAKE_SNOWFLAKE_FAST
-#undef MAKE_SNOWFLAKE_FAST
-#endif
 }  // namespace lf
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+
+#include "lockfree.h"
+
+namespace lf {
+
+// bounded single producer single consumer ring of snowflakes
+template <std::size_t Capacity>
+class SpscRing {
+ public:
+  static_assert(std::has_single_bit(Capacity), "capacity must be 2^n");
+
+  // producer only, false when full
+  bool push(u64 value) noexcept {
+    auto const tail = atm_Tail.load(std::memory_order_relaxed);
+    if (tail - m_CachedHead == Capacity) {
+      m_CachedHead = atm_Head.load(std::memory_order_acquire);
+      if (tail - m_CachedHead == Capacity) {
+        return false;
+      }
+    }
+    m_Slots[tail % Capacity] = value;
+    atm_Tail.store(tail + 1ull, std::memory_order_release);
+    return true;
+  }
+
+  // consumer only, false when empty
+  bool pop(u64& value) noexcept {
+    auto const head = atm_Head.load(std::memory_order_relaxed);
+    if (head == m_CachedTail) {
+      m_CachedTail = atm_Tail.load(std::memory_order_acquire);
+      if (head == m_CachedTail) {
+        return false;
+      }
+    }
+    value = m_Slots[head % Capacity];
+    atm_Head.store(head + 1ull, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // consumer line, the cached tail saves a load of the producer's line
+  alignas(64) std::atomic<u64> atm_Head{0ull};
+  u64 m_CachedTail = 0ull;
+  // producer line
+  alignas(64) std::atomic<u64> atm_Tail{0ull};
+  u64 m_CachedHead = 0ull;
+  alignas(64) std::array<u64, Capacity> m_Slots;
+};
+
+// bounded multi producer multi consumer ring of snowflakes (Vyukov's queue),
+// every cell carries a sequence telling whether it is ready to be written or
+// read, so push and pop are a single CAS on their position
+template <std::size_t Capacity>
+class MpmcRing {
+ public:
+  static_assert(std::has_single_bit(Capacity), "capacity must be 2^n");
+
+  MpmcRing() noexcept {
+    for (std::size_t i = 0; i < Capacity; i++) {
+      m_Cells[i].atm_Sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool push(u64 value) noexcept {
+    auto position = atm_EnqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& cell = m_Cells[position % Capacity];
+      auto const sequence = cell.atm_Sequence.load(std::memory_order_acquire);
+      auto const difference = static_cast<std::int64_t>(sequence - position);
+      if (difference == 0) {
+        if (atm_EnqueuePosition.compare_exchange_weak(
+                position, position + 1ull, std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.atm_Sequence.store(position + 1ull, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        // full
+        return false;
+      } else {
+        position = atm_EnqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool pop(u64& value) noexcept {
+    auto position = atm_DequeuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& cell = m_Cells[position % Capacity];
+      auto const sequence = cell.atm_Sequence.load(std::memory_order_acquire);
+      auto const difference =
+          static_cast<std::int64_t>(sequence - (position + 1ull));
+      if (difference == 0) {
+        if (atm_DequeuePosition.compare_exchange_weak(
+                position, position + 1ull, std::memory_order_relaxed)) {
+          value = cell.value;
+          cell.atm_Sequence.store(position + Capacity,
+                                  std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        // empty
+        return false;
+      } else {
+        position = atm_DequeuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<u64> atm_Sequence;
+    u64 value;
+  };
+
+  alignas(64) std::atomic<u64> atm_EnqueuePosition{0ull};
+  alignas(64) std::atomic<u64> atm_DequeuePosition{0ull};
+  alignas(64) std::array<Cell, Capacity> m_Cells;
+};
+
+// A producer thread keeping a ring (SpscRing or MpmcRing) of snowflakes of
+// the process-wide generator full, consumers pop a ready snowflake without
+// reading the clock or touching the generator. The producer also publishes
+// the current millisecond, snowflakes older than maxAge_ms are discarded by
+// the consumers so the popped timestamps stay close to the clock. An SpscRing
+// must have a single consumer thread (ie. a thread_local IdPrefetcher).
+// Taking ids from the process-wide generator (default) shares its 4096 ids
+// per millisecond with lf::get callers
+template <typename Ring>
+class IdPrefetcher {
+ public:
+  // ids claimed from the generator at once
+  static constexpr u64 kBatchSize = 64ull;
+  // how long the producer sleeps while the ring is full or the millisecond
+  // is exhausted
+  static constexpr std::chrono::microseconds kIdleInterval{20};
+
+  IdPrefetcher(u64 mpid, u64 maxAge_ms,
+               Generator& generator = v4d::g_Generator) noexcept
+      : m_Generator(generator),
+        m_Mpid(mpid),
+        m_MaxAge_ms(maxAge_ms),
+        m_Thread([this](std::stop_token stopToken) { produce(stopToken); }) {}
+
+  IdPrefetcher(IdPrefetcher const&) = delete;
+  IdPrefetcher& operator=(IdPrefetcher const&) = delete;
+
+  // next ready snowflake, 0 while the ring is empty
+  u64 get() noexcept {
+    auto const timestamp = atm_Millis.load(std::memory_order_relaxed);
+    auto const oldestTimestamp =
+        (timestamp > m_MaxAge_ms) ? timestamp - m_MaxAge_ms : 0ull;
+    u64 snowflake;
+    while (m_Ring.pop(snowflake)) {
+      if (DefaultLayout::getTimestamp(snowflake) >= oldestTimestamp) {
+        return snowflake;
+      }
+    }
+    return 0ull;
+  }
+
+ private:
+  void produce(std::stop_token stopToken) noexcept {
+    std::array<u64, kBatchSize> batch;
+    std::size_t count = 0;
+    std::size_t pushed = 0;
+    while (!stopToken.stop_requested()) {
+      atm_Millis.store(currentTimestamp(), std::memory_order_relaxed);
+
+      if (pushed == count) {
+        count = m_Generator.getBatch(m_Mpid, kBatchSize, batch);
+        pushed = 0;
+        if (count == 0) {
+          // the millisecond is exhausted, spinning would burn a core per
+          // producer until the edge
+          std::this_thread::sleep_for(kIdleInterval);
+          continue;
+        }
+      }
+
+      while ((pushed < count) && m_Ring.push(batch[pushed])) {
+        pushed++;
+      }
+      if (pushed < count) {
+        std::this_thread::sleep_for(kIdleInterval);
+      }
+    }
+  }
+
+  // timestamps wrap with the layout, compare them in the same width
+  static u64 currentTimestamp() noexcept {
+    return DefaultLayout::toTicks(utils::millis()) bitand
+           (DefaultLayout::kTimestampMask >> DefaultLayout::kTimestampShift);
+  }
+
+  Ring m_Ring;
+  Generator& m_Generator;
+  u64 const m_Mpid;
+  u64 const m_MaxAge_ms;
+  // current millisecond as a snowflake timestamp, written by the producer
+  alignas(64) std::atomic<u64> atm_Millis{currentTimestamp()};
+  // declared last so the thread starts after the state above is initialized
+  std::jthread m_Thread;
+};
+
+}  // namespace lf
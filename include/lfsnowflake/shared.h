@@ -0,0 +1,163 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <type_traits>
+
+#include "lockfree.h"
+
+namespace lf {
+
+// A generator whose compact sequence lives in a named POSIX shared memory
+// segment (shm_open), so every process on a host can issue ids for the same
+// MPID lock free, with the v4d algorithm. The first process to attach creates
+// and initializes the segment under an flock on it, later ones take the same
+// lock and find it published. The kernel drops the lock of a creator that dies
+// while initializing, so the next process initializes it instead.
+//
+// Only stateless clocks that count the same milliseconds in every process may
+// be used (ie. not lf::clock::Tsc or lf::clock::Ticker, the default falls back
+// to lf::clock::Steady when LFSNOWFLAKE_CLOCK is one of them), and
+// getBlocking() is not offered since std::atomic::wait does not wake waiters
+// in other processes
+template <typename Clock = std::conditional_t<
+              clock::kIsProcessLocal<clock::Default>, clock::Steady,
+              clock::Default>,
+          typename LayoutT = DefaultLayout>
+class SharedGenerator {
+ public:
+  using GeneratorType = BasicGenerator<Clock, LayoutT>;
+
+  static_assert(std::is_empty_v<Clock> && !clock::kIsProcessLocal<Clock>,
+                "the clock must count the same milliseconds in every process");
+  static_assert(std::atomic<u64>::is_always_lock_free,
+                "the shared atomics must not need a lock");
+
+  static constexpr u64 kMagic = 0x4c46534e'4f575348ull;  // LFSNOWSH
+  static constexpr u64 kVersion = 1ull;
+
+  // name follows shm_open, ie. "/app-snowflake"
+  explicit SharedGenerator(char const* name) noexcept {
+    m_Fd = ::shm_open(name, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (m_Fd < 0) {
+      return;
+    }
+
+    // a new segment is zero filled, every attacher sizes it the same way
+    struct stat status;
+    if ((::fstat(m_Fd, &status) != 0) ||
+        ((status.st_size != 0) && (status.st_size != sizeof(Segment))) ||
+        (::ftruncate(m_Fd, sizeof(Segment)) != 0)) {
+      close();
+      return;
+    }
+
+    void* mapping = ::mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE,
+                           MAP_SHARED, m_Fd, 0);
+    if (mapping == MAP_FAILED) {
+      close();
+      return;
+    }
+    m_Segment = static_cast<Segment*>(mapping);
+
+    if (!attach()) {
+      close();
+    }
+  }
+
+  ~SharedGenerator() noexcept { close(); }
+
+  SharedGenerator(SharedGenerator const&) = delete;
+  SharedGenerator& operator=(SharedGenerator const&) = delete;
+
+  bool isOpen() const noexcept { return m_Segment != nullptr; }
+
+  u64 get(u64 mpid) noexcept { return generator().get(mpid); }
+
+  Reservation reserve(u64 n) noexcept { return generator().reserve(n); }
+
+  std::size_t getBatch(u64 mpid, u64 n, std::span<u64> out) noexcept {
+    return generator().getBatch(mpid, n, out);
+  }
+
+  // removes the segment name, attached processes keep their mapping
+  static bool remove(char const* name) noexcept {
+    return ::shm_unlink(name) == 0;
+  }
+
+ private:
+  enum State : u64 { kEmpty = 0ull, kReady = 2ull };
+
+  struct Segment {
+    std::atomic<u64> state;
+    u64 magic;
+    u64 version;
+    // the layout must match between the processes
+    u64 sequenceBits;
+    u64 mpidBits;
+    u64 timestampBits;
+    u64 epoch;
+    u64 millisPerTick;
+    alignas(GeneratorType) unsigned char generator[sizeof(GeneratorType)];
+  };
+
+  bool attach() noexcept {
+    // initialization runs only under the lock and only on a segment that was
+    // never published, a published one is never initialized again
+    if (::flock(m_Fd, LOCK_EX) != 0) {
+      return false;
+    }
+    if (m_Segment->state.load(std::memory_order_acquire) != kReady) {
+      initialize();
+    }
+    ::flock(m_Fd, LOCK_UN);
+
+    return (m_Segment->magic == kMagic) && (m_Segment->version == kVersion) &&
+           (m_Segment->sequenceBits == LayoutT::kSequenceBits) &&
+           (m_Segment->mpidBits == LayoutT::kMpidBits) &&
+           (m_Segment->timestampBits == LayoutT::kTimestampBits) &&
+           (m_Segment->epoch == LayoutT::kEpoch) &&
+           (m_Segment->millisPerTick == LayoutT::kMillisPerTick);
+  }
+
+  void initialize() noexcept {
+    m_Segment->magic = kMagic;
+    m_Segment->version = kVersion;
+    m_Segment->sequenceBits = LayoutT::kSequenceBits;
+    m_Segment->mpidBits = LayoutT::kMpidBits;
+    m_Segment->timestampBits = LayoutT::kTimestampBits;
+    m_Segment->epoch = LayoutT::kEpoch;
+    m_Segment->millisPerTick = LayoutT::kMillisPerTick;
+    ::new (static_cast<void*>(m_Segment->generator)) GeneratorType();
+    m_Segment->state.store(kReady, std::memory_order_release);
+  }
+
+  GeneratorType& generator() noexcept {
+    return *std::launder(
+        reinterpret_cast<GeneratorType*>(m_Segment->generator));
+  }
+
+  void close() noexcept {
+    if (m_Segment != nullptr) {
+      ::munmap(m_Segment, sizeof(Segment));
+      m_Segment = nullptr;
+    }
+    if (m_Fd >= 0) {
+      ::close(m_Fd);
+      m_Fd = -1;
+    }
+  }
+
+  int m_Fd = -1;
+  Segment* m_Segment = nullptr;
+};
+
+}  // namespace lf
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "layout.h"
+
+namespace lf {
+namespace sort {
+
+// Ordering of snowflake arrays. lf::sort::merge joins runs that are already
+// sorted (ie. the ids of every generating thread) into one time ordered
+// stream, lf::sort::radixSort sorts arbitrary arrays of snowflakes.
+
+// Tournament (loser) tree over k sorted runs: every inner node keeps the
+// loser of its match, so replacing the winner replays only the log2(k)
+// matches on its path to the root, one comparison per level.
+class LoserTree {
+ public:
+  explicit LoserTree(std::span<std::span<u64 const> const> runs)
+      : m_LeafCount(std::bit_ceil(std::max<std::size_t>(std::size(runs), 1))),
+        m_Runs(m_LeafCount),
+        m_Positions(m_LeafCount, 0),
+        m_Tree(m_LeafCount, 0) {
+    std::copy(std::begin(runs), std::end(runs), std::begin(m_Runs));
+
+    // play every match bottom up, winners move up and losers stay
+    std::vector<std::size_t> winners(2 * m_LeafCount);
+    for (std::size_t i = 0; i < m_LeafCount; i++) {
+      winners[m_LeafCount + i] = i;
+    }
+    for (std::size_t node = m_LeafCount - 1; node > 0; node--) {
+      auto const left = winners[2 * node];
+      auto const right = winners[2 * node + 1];
+      if (isLess(right, left)) {
+        winners[node] = right;
+        m_Tree[node] = left;
+      } else {
+        winners[node] = left;
+        m_Tree[node] = right;
+      }
+    }
+    m_Tree[0] = winners[1];
+  }
+
+  bool empty() const noexcept { return isDone(m_Tree[0]); }
+
+  // smallest remaining value and the index of its run, only if !empty()
+  u64 top() const noexcept {
+    return m_Runs[m_Tree[0]][m_Positions[m_Tree[0]]];
+  }
+  std::size_t topRun() const noexcept { return m_Tree[0]; }
+
+  void pop() noexcept {
+    auto winner = m_Tree[0];
+    m_Positions[winner]++;
+    for (auto node = (m_LeafCount + winner) / 2; node > 0; node /= 2) {
+      if (isLess(m_Tree[node], winner)) {
+        std::swap(m_Tree[node], winner);
+      }
+    }
+    m_Tree[0] = winner;
+  }
+
+ private:
+  bool isDone(std::size_t run) const noexcept {
+    return m_Positions[run] == std::size(m_Runs[run]);
+  }
+
+  // exhausted runs lose every match
+  bool isLess(std::size_t a, std::size_t b) const noexcept {
+    if (isDone(a)) {
+      return false;
+    }
+    if (isDone(b)) {
+      return true;
+    }
+    return m_Runs[a][m_Positions[a]] < m_Runs[b][m_Positions[b]];
+  }
+
+  std::size_t m_LeafCount;
+  std::vector<std::span<u64 const>> m_Runs;
+  std::vector<std::size_t> m_Positions;
+  // [0]: overall winner, [1, m_LeafCount): loser of the match at that node
+  std::vector<std::size_t> m_Tree;
+};
+
+// calls visit(value) for the values of every run in ascending order
+template <typename Visitor>
+inline void forEachMerged(std::span<std::span<u64 const> const> runs,
+                          Visitor&& visit) {
+  LoserTree tree(runs);
+  while (!tree.empty()) {
+    visit(tree.top());
+    tree.pop();
+  }
+}
+
+// merges sorted runs into out, which must hold the values of every run
+inline void merge(std::span<std::span<u64 const> const> runs,
+                  std::span<u64> out) {
+  std::size_t i = 0;
+  forEachMerged(runs, [&](u64 value) { out[i++] = value; });
+}
+
+namespace detail {
+// 11 bit digits: 2,048 counters per thread stay in L1, 6 passes cover 63 bits
+inline constexpr u64 kDigitBits = 11ull;
+inline constexpr std::size_t kBucketCount = std::size_t{1} << kDigitBits;
+inline constexpr u64 kDigitMask = kBucketCount - 1ull;
+// below this size a comparison sort beats clearing the counters
+inline constexpr std::size_t kSmallSortSize = 1'024;
+
+using Counts = std::array<std::size_t, kBucketCount>;
+
+// calls task(i) for i in [0, threadCount) on threadCount threads
+template <typename Task>
+inline void parallelFor(std::size_t threadCount, Task const& task) {
+  if (threadCount <= 1) {
+    task(std::size_t{0});
+    return;
+  }
+  std::vector<std::jthread> jThreadPool;
+  for (std::size_t i = 0; i < threadCount; i++) {
+    jThreadPool.emplace_back([&task, i]() { task(i); });
+  }
+}
+}  // namespace detail
+
+// LSD radix sort of values whose bits above keyBits are zero, using scratch
+// (at least as large as values) as the second buffer and threadCount threads
+// on contiguous chunks. Digits that are equal in every value (the high
+// timestamp bits of ids from one run, unused mpid bits) are skipped, so the
+// pass count follows the bits that actually vary.
+inline void radixSort(std::span<u64> values, std::span<u64> scratch,
+                      u64 keyBits, std::size_t threadCount = 1) {
+  auto const count = std::size(values);
+  if (count < detail::kSmallSortSize) {
+    std::sort(std::begin(values), std::end(values));
+    return;
+  }
+  threadCount = std::clamp<std::size_t>(threadCount, 1, count);
+  auto const chunkSize = (count + threadCount - 1) / threadCount;
+  auto const chunkBegin = [&](std::size_t i) {
+    return std::min(i * chunkSize, count);
+  };
+
+  // bits that differ from the first value somewhere
+  std::vector<u64> variedBits(threadCount, 0ull);
+  detail::parallelFor(threadCount, [&](std::size_t t) {
+    auto const first = values[0];
+    u64 varied = 0ull;
+    for (auto i = chunkBegin(t); i < chunkBegin(t + 1); i++) {
+      varied |= values[i] ^ first;
+    }
+    variedBits[t] = varied;
+  });
+  u64 varied = 0ull;
+  for (auto const bits : variedBits) {
+    varied |= bits;
+  }
+  if (keyBits < 64ull) {
+    varied &= (1ull << keyBits) - 1ull;
+  }
+
+  std::span<u64> source = values;
+  std::span<u64> destination = scratch.first(count);
+  std::vector<detail::Counts> offsets(threadCount);
+  for (u64 shift = 0ull; shift < keyBits; shift += detail::kDigitBits) {
+    if (((varied >> shift) & detail::kDigitMask) == 0ull) {
+      continue;
+    }
+
+    detail::parallelFor(threadCount, [&](std::size_t t) {
+      auto& counts = offsets[t];
+      counts.fill(0);
+      for (auto i = chunkBegin(t); i < chunkBegin(t + 1); i++) {
+        counts[(source[i] >> shift) & detail::kDigitMask]++;
+      }
+    });
+
+    // bucket major, thread minor: every thread scatters into its own slices
+    std::size_t offset = 0;
+    for (std::size_t bucket = 0; bucket < detail::kBucketCount; bucket++) {
+      for (auto& counts : offsets) {
+        auto const bucketCount = counts[bucket];
+        counts[bucket] = offset;
+        offset += bucketCount;
+      }
+    }
+
+    detail::parallelFor(threadCount, [&](std::size_t t) {
+      auto& positions = offsets[t];
+      for (auto i = chunkBegin(t); i < chunkBegin(t + 1); i++) {
+        auto const value = source[i];
+        destination[positions[(value >> shift) & detail::kDigitMask]++] =
+            value;
+      }
+    });
+    std::swap(source, destination);
+  }
+
+  if (std::data(source) != std::data(values)) {
+    detail::parallelFor(threadCount, [&](std::size_t t) {
+      std::copy(std::begin(source) + static_cast<std::ptrdiff_t>(chunkBegin(t)),
+                std::begin(source) +
+                    static_cast<std::ptrdiff_t>(chunkBegin(t + 1)),
+                std::begin(values) +
+                    static_cast<std::ptrdiff_t>(chunkBegin(t)));
+    });
+  }
+}
+
+// radix sort of snowflakes of LayoutT, the key is as wide as the layout's
+// fields (the unused top bits are never visited)
+template <typename LayoutT = DefaultLayout>
+inline void radixSort(std::span<u64> values, std::span<u64> scratch,
+                      std::size_t threadCount = 1) {
+  radixSort(values, scratch,
+            LayoutT::kTimestampBits + LayoutT::kMpidBits +
+                LayoutT::kSequenceBits,
+            threadCount);
+}
+
+}  // namespace sort
+}  // namespace lf
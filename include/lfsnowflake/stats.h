@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// LFSNOWFLAKE_STATS: count the contention events of the generators, the
+// counters are per thread (single writer, own cache line) and aggregated by
+// lf::stats::snapshot(). Without it every counter compiles to nothing
+
+namespace lf {
+namespace stats {
+
+#ifdef LFSNOWFLAKE_STATS
+inline constexpr bool kEnabled = true;
+#else
+inline constexpr bool kEnabled = false;
+#endif
+
+enum Counter : std::size_t {
+  kCasFailures,
+  kExhausted,
+  kResetsWon,
+  kIssued,
+  kBorrowed,
+  // gauge, the snapshot holds the maximum over the threads
+  kMaxAhead,
+  kCounterCount
+};
+
+// totals over every thread (including exited ones) and every generator
+struct Snapshot {
+  // millisecond resets lost to another thread
+  std::uint64_t casFailures = 0ull;
+  // calls that found the sequence of the millisecond used up (returned 0)
+  std::uint64_t exhausted = 0ull;
+  // millisecond resets performed
+  std::uint64_t resetsWon = 0ull;
+  // sequence numbers handed out (reserved ones included)
+  std::uint64_t issued = 0ull;
+  // sequence numbers issued ahead of the clock (burst credit)
+  std::uint64_t borrowed = 0ull;
+  // most ticks a generator ran ahead of the clock
+  std::uint64_t maxAhead = 0ull;
+};
+
+#ifdef LFSNOWFLAKE_STATS
+namespace detail {
+using Counts = std::array<std::atomic<std::uint64_t>, kCounterCount>;
+
+// counters of the threads alive, and the sum of the ones that exited
+struct Registry {
+  std::mutex mutex;
+  std::vector<Counts const*> threads;
+  std::array<std::uint64_t, kCounterCount> retired{};
+};
+
+inline Registry g_Registry;
+
+// counters are summed, gauges keep their maximum
+inline void merge(std::uint64_t& total, Counter counter,
+                  std::uint64_t value) noexcept {
+  total = (counter == kMaxAhead) ? std::max(total, value) : total + value;
+}
+
+struct alignas(64) ThreadCounters {
+  ThreadCounters() {
+    std::scoped_lock lock(g_Registry.mutex);
+    g_Registry.threads.push_back(&counts);
+  }
+
+  ~ThreadCounters() {
+    std::scoped_lock lock(g_Registry.mutex);
+    for (std::size_t i = 0; i < kCounterCount; i++) {
+      merge(g_Registry.retired[i], static_cast<Counter>(i),
+            counts[i].load(std::memory_order_relaxed));
+    }
+    std::erase(g_Registry.threads, &counts);
+  }
+
+  Counts counts{};
+};
+
+inline thread_local ThreadCounters tl_Counters;
+}  // namespace detail
+#endif
+
+// adds n to a counter of the calling thread, a plain load and store since
+// only the owning thread writes it
+inline void count([[maybe_unused]] Counter counter,
+                  [[maybe_unused]] std::uint64_t n = 1ull) noexcept {
+#ifdef LFSNOWFLAKE_STATS
+  auto& value = detail::tl_Counters.counts[counter];
+  value.store(value.load(std::memory_order_relaxed) + n,
+              std::memory_order_relaxed);
+#endif
+}
+
+// raises a gauge of the calling thread to value
+inline void observeMax([[maybe_unused]] Counter counter,
+                       [[maybe_unused]] std::uint64_t value) noexcept {
+#ifdef LFSNOWFLAKE_STATS
+  auto& gauge = detail::tl_Counters.counts[counter];
+  if (value > gauge.load(std::memory_order_relaxed)) {
+    gauge.store(value, std::memory_order_relaxed);
+  }
+#endif
+}
+
+// sums the counters of every thread, all zero without LFSNOWFLAKE_STATS
+inline Snapshot snapshot() {
+  std::array<std::uint64_t, kCounterCount> totals{};
+#ifdef LFSNOWFLAKE_STATS
+  std::scoped_lock lock(detail::g_Registry.mutex);
+  totals = detail::g_Registry.retired;
+  for (auto const* counts : detail::g_Registry.threads) {
+    for (std::size_t i = 0; i < kCounterCount; i++) {
+      detail::merge(totals[i], static_cast<Counter>(i),
+                    (*counts)[i].load(std::memory_order_relaxed));
+    }
+  }
+#endif
+  return {totals[kCasFailures], totals[kExhausted], totals[kResetsWon],
+          totals[kIssued],      totals[kBorrowed],  totals[kMaxAhead]};
+}
+
+}  // namespace stats
+}  // namespace lf
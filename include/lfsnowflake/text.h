@@ -0,0 +1,518 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "bulk.h"
+#include "layout.h"
+
+namespace lf {
+namespace text {
+
+// Text forms of snowflakes for APIs. Base32 (Crockford alphabet, 13 chars)
+// and base62 (0-9A-Za-z, 11 chars) are fixed width with alphabets in ascii
+// order, so the strings of ascending ids sort ascending. Decimal is variable
+// width like std::to_chars. The span based encodeX/decodeX convert arrays
+// and pick an AVX2 kernel at runtime (base62 decodes with table lookups
+// only), the per instruction set kernels are exposed for benchmarking.
+
+inline constexpr std::size_t kBase32Size = 13;
+inline constexpr std::size_t kBase62Size = 11;
+// digits of the largest u64
+inline constexpr std::size_t kDecimalMaxSize = 20;
+
+namespace detail {
+inline constexpr char kBase32Alphabet[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+inline constexpr char kBase62Alphabet[] =
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+inline constexpr std::uint8_t kInvalid = 0xff;
+
+// char -> digit value, kInvalid for chars outside the alphabet; base32
+// decodes case insensitive and maps I, L to 1 and O to 0 (Crockford)
+inline constexpr auto kBase32Values = []() {
+  std::array<std::uint8_t, 256> values{};
+  values.fill(kInvalid);
+  for (std::uint8_t i = 0; i < 32; i++) {
+    auto const c = static_cast<unsigned char>(kBase32Alphabet[i]);
+    values[c] = i;
+    values[c bitor 0x20u] = i;
+  }
+  for (auto const& [c, value] : {std::pair{'I', 1}, std::pair{'L', 1},
+                                std::pair{'O', 0}}) {
+    values[static_cast<unsigned char>(c)] = static_cast<std::uint8_t>(value);
+    values[static_cast<unsigned char>(c) bitor 0x20u] =
+        static_cast<std::uint8_t>(value);
+  }
+  return values;
+}();
+
+inline constexpr auto kBase62Values = []() {
+  std::array<std::uint8_t, 256> values{};
+  values.fill(kInvalid);
+  for (std::uint8_t i = 0; i < 62; i++) {
+    values[static_cast<unsigned char>(kBase62Alphabet[i])] = i;
+  }
+  return values;
+}();
+
+// "00" "01" ... "99"
+inline constexpr auto kDigitPairs = []() {
+  std::array<char, 200> pairs{};
+  for (std::size_t i = 0; i < 100; i++) {
+    pairs[2 * i] = static_cast<char>('0' + i / 10);
+    pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+  }
+  return pairs;
+}();
+
+inline constexpr u64 k62Pow5 = 62ull * 62ull * 62ull * 62ull * 62ull;
+}  // namespace detail
+
+// writes the kBase32Size chars of snowflake to out
+inline void toBase32(u64 snowflake, char* out) noexcept {
+  for (std::size_t i = kBase32Size; i-- > 0;) {
+    out[i] = detail::kBase32Alphabet[snowflake bitand 31ull];
+    snowflake >>= 5;
+  }
+}
+
+inline bool fromBase32(std::string_view text, u64& snowflake) noexcept {
+  if (std::size(text) != kBase32Size) {
+    return false;
+  }
+  u64 value = 0ull;
+  for (std::size_t i = 0; i < kBase32Size; i++) {
+    auto const digit =
+        detail::kBase32Values[static_cast<unsigned char>(text[i])];
+    // the first char holds the top 4 bits only
+    if ((digit == detail::kInvalid) || (i == 0 && digit > 15u)) {
+      return false;
+    }
+    value = (value << 5) bitor digit;
+  }
+  snowflake = value;
+  return true;
+}
+
+// writes the kBase62Size chars of snowflake to out
+inline void toBase62(u64 snowflake, char* out) noexcept {
+  for (std::size_t i = kBase62Size; i-- > 0;) {
+    out[i] = detail::kBase62Alphabet[snowflake % 62ull];
+    snowflake /= 62ull;
+  }
+}
+
+inline bool fromBase62(std::string_view text, u64& snowflake) noexcept {
+  if (std::size(text) != kBase62Size) {
+    return false;
+  }
+  u64 value = 0ull;
+  for (auto const c : text) {
+    auto const digit = detail::kBase62Values[static_cast<unsigned char>(c)];
+    // 62^11 > 2^64, the largest strings do not fit
+    if ((digit == detail::kInvalid) ||
+        __builtin_mul_overflow(value, 62ull, &value) ||
+        __builtin_add_overflow(value, u64{digit}, &value)) {
+      return false;
+    }
+  }
+  snowflake = value;
+  return true;
+}
+
+// writes the decimal digits of snowflake (at most kDecimalMaxSize) to out,
+// returns the end of the digits
+inline char* toChars(u64 snowflake, char* out) noexcept {
+  char digits[kDecimalMaxSize];
+  auto* begin = digits + kDecimalMaxSize;
+  while (snowflake >= 100ull) {
+    auto const pair = static_cast<std::size_t>(snowflake % 100ull) * 2;
+    snowflake /= 100ull;
+    begin -= 2;
+    std::memcpy(begin, std::data(detail::kDigitPairs) + pair, 2);
+  }
+  if (snowflake >= 10ull) {
+    begin -= 2;
+    std::memcpy(begin, std::data(detail::kDigitPairs) + snowflake * 2, 2);
+  } else {
+    *--begin = static_cast<char>('0' + snowflake);
+  }
+  auto const size = static_cast<std::size_t>(digits + kDecimalMaxSize - begin);
+  std::memcpy(out, begin, size);
+  return out + size;
+}
+
+inline bool fromChars(std::string_view text, u64& snowflake) noexcept {
+  auto const* end = std::data(text) + std::size(text);
+  auto const [pointer, error] =
+      std::from_chars(std::data(text), end, snowflake);
+  return (error == std::errc{}) && (pointer == end) && !text.empty();
+}
+
+// Batches: out holds size(snowflakes) fixed width strings back to back,
+// decodeX returns false if any string is invalid (snowflakes is then
+// partially written). encodeDecimal writes every id followed by separator
+// and returns the chars written, out needs kDecimalMaxSize + 1 per id.
+namespace scalar {
+inline void encodeBase32(std::span<u64 const> snowflakes,
+                         std::span<char> out) noexcept {
+  for (std::size_t i = 0; i < std::size(snowflakes); i++) {
+    toBase32(snowflakes[i], std::data(out) + i * kBase32Size);
+  }
+}
+
+inline bool decodeBase32(std::span<char const> text,
+                         std::span<u64> snowflakes) noexcept {
+  for (std::size_t i = 0; i < std::size(snowflakes); i++) {
+    if (!fromBase32({std::data(text) + i * kBase32Size, kBase32Size},
+                    snowflakes[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline void encodeBase62(std::span<u64 const> snowflakes,
+                         std::span<char> out) noexcept {
+  for (std::size_t i = 0; i < std::size(snowflakes); i++) {
+    toBase62(snowflakes[i], std::data(out) + i * kBase62Size);
+  }
+}
+
+inline bool decodeBase62(std::span<char const> text,
+                         std::span<u64> snowflakes) noexcept {
+  for (std::size_t i = 0; i < std::size(snowflakes); i++) {
+    if (!fromBase62({std::data(text) + i * kBase62Size, kBase62Size},
+                    snowflakes[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline std::size_t encodeDecimal(std::span<u64 const> snowflakes,
+                                 std::span<char> out,
+                                 char separator) noexcept {
+  auto* end = std::data(out);
+  for (auto const snowflake : snowflakes) {
+    end = toChars(snowflake, end);
+    *end++ = separator;
+  }
+  return static_cast<std::size_t>(end - std::data(out));
+}
+}  // namespace scalar
+
+#if defined(__x86_64__)
+namespace avx2 {
+// base32: pdep spreads the 5 bit groups into bytes, pshufb reverses them to
+// msb first and looks up the alphabet (two 16 entry halves)
+__attribute__((target("avx2,bmi2"))) inline __m128i base32Digits(
+    u64 snowflake) noexcept {
+  auto const low = _pdep_u64(snowflake, 0x1f1f1f1f'1f1f1f1full);
+  auto const high = _pdep_u64(snowflake >> 40, 0x0000001f'1f1f1f1full);
+  auto const groups = _mm_set_epi64x(static_cast<long long>(high),
+                                     static_cast<long long>(low));
+  // char i <- group byte: 12..8 (high), 7..0 (low), 3 unused
+  return _mm_shuffle_epi8(
+      groups, _mm_setr_epi8(12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, -1, -1,
+                            -1));
+}
+
+__attribute__((target("avx2,bmi2"))) inline __m128i base32Chars(
+    u64 snowflake) noexcept {
+  auto const digits = base32Digits(snowflake);
+  auto const lowAlphabet = _mm_loadu_si128(
+      reinterpret_cast<__m128i const*>(detail::kBase32Alphabet));
+  auto const highAlphabet = _mm_loadu_si128(
+      reinterpret_cast<__m128i const*>(detail::kBase32Alphabet + 16));
+  return _mm_blendv_epi8(_mm_shuffle_epi8(lowAlphabet, digits),
+                         _mm_shuffle_epi8(highAlphabet, digits),
+                         _mm_cmpgt_epi8(digits, _mm_set1_epi8(15)));
+}
+
+__attribute__((target("avx2,bmi2"))) inline void encodeBase32(
+    std::span<u64 const> snowflakes, std::span<char> out) noexcept {
+  // 16 byte stores overlap the next id, the last id goes through a buffer
+  auto const count = std::size(snowflakes);
+  for (std::size_t i = 0; i + 1 < count; i++) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(std::data(out) + i * kBase32Size),
+        base32Chars(snowflakes[i]));
+  }
+  if (count != 0) {
+    char last[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(last),
+                     base32Chars(snowflakes[count - 1]));
+    std::memcpy(std::data(out) + (count - 1) * kBase32Size, last,
+                kBase32Size);
+  }
+}
+
+// chars -> 5 bit groups by high nibble (3: digits, 4/6: @A-O, 5/7: P-_),
+// pext packs the groups back into the id; reads 16 chars
+__attribute__((target("avx2,bmi2"))) inline bool fromBase32Chars(
+    char const* chars, u64& snowflake) noexcept {
+  constexpr char X = static_cast<char>(detail::kInvalid);
+  auto const digits =
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, X, X, X, X, X, X);
+  auto const letters0 = _mm_setr_epi8(X, 10, 11, 12, 13, 14, 15, 16, 17, 1,
+                                      18, 19, 1, 20, 21, 0);
+  auto const letters1 = _mm_setr_epi8(22, 23, 24, 25, 26, X, 27, 28, 29, 30,
+                                      31, X, X, X, X, X);
+  auto const nibbleMask = _mm_set1_epi8(0x0f);
+
+  auto const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(chars));
+  auto const low = _mm_and_si128(input, nibbleMask);
+  auto const high = _mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask);
+  // 4 and 6 -> 6, 5 and 7 -> 7
+  auto const highCase = _mm_or_si128(high, _mm_set1_epi8(2));
+  auto values = _mm_set1_epi8(X);
+  values = _mm_blendv_epi8(values, _mm_shuffle_epi8(digits, low),
+                           _mm_cmpeq_epi8(high, _mm_set1_epi8(3)));
+  values = _mm_blendv_epi8(values, _mm_shuffle_epi8(letters0, low),
+                           _mm_cmpeq_epi8(highCase, _mm_set1_epi8(6)));
+  values = _mm_blendv_epi8(values, _mm_shuffle_epi8(letters1, low),
+                           _mm_cmpeq_epi8(highCase, _mm_set1_epi8(7)));
+
+  // invalid chars have the top bit set, the first char holds 4 bits, bytes
+  // 13..15 belong to the next id
+  auto const limits = _mm_setr_epi8(15, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+                                    31, 31, 31, 0, 0, 0);
+  auto const used = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                  -1, -1, -1, 0, 0, 0);
+  auto const invalid = _mm_and_si128(
+      _mm_or_si128(values, _mm_cmpgt_epi8(values, limits)), used);
+  if (_mm_movemask_epi8(invalid) != 0) {
+    return false;
+  }
+
+  // group bytes in lsb first order: 12..5 (low 40 bits), 4..0 (high 24)
+  auto const groups = _mm_shuffle_epi8(
+      values, _mm_setr_epi8(12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, -1, -1,
+                            -1));
+  auto const lowGroups = static_cast<u64>(_mm_cvtsi128_si64(groups));
+  auto const highGroups = static_cast<u64>(_mm_extract_epi64(groups, 1));
+  snowflake = _pext_u64(lowGroups, 0x1f1f1f1f'1f1f1f1full) bitor
+              (_pext_u64(highGroups, 0x0000001f'1f1f1f1full) << 40);
+  return true;
+}
+
+__attribute__((target("avx2,bmi2"))) inline bool decodeBase32(
+    std::span<char const> text, std::span<u64> snowflakes) noexcept {
+  auto const count = std::size(snowflakes);
+  for (std::size_t i = 0; i + 1 < count; i++) {
+    if (!fromBase32Chars(std::data(text) + i * kBase32Size, snowflakes[i])) {
+      return false;
+    }
+  }
+  if (count != 0) {
+    char last[16] = {};
+    std::memcpy(last, std::data(text) + (count - 1) * kBase32Size,
+                kBase32Size);
+    return fromBase32Chars(last, snowflakes[count - 1]);
+  }
+  return true;
+}
+
+// base62: two divisions by 62^5 split an id into a leading digit and two
+// 5 digit parts below 2^30, the parts of 2 ids are divided by 62 in the 4
+// lanes at once ((x * 1108378658) >> 36 == x / 62 for x < 62^5)
+__attribute__((target("avx2"))) inline void toBase62Pair(u64 first,
+                                                         u64 second,
+                                                         char* chars) noexcept {
+  auto const reciprocal = _mm256_set1_epi64x(1108378658ll);
+  auto const base = _mm256_set1_epi64x(62ll);
+
+  auto const firstTop = first / detail::k62Pow5;
+  auto const secondTop = second / detail::k62Pow5;
+  auto parts =
+      _mm256_setr_epi64x(static_cast<long long>(firstTop % detail::k62Pow5),
+                         static_cast<long long>(first % detail::k62Pow5),
+                         static_cast<long long>(secondTop % detail::k62Pow5),
+                         static_cast<long long>(second % detail::k62Pow5));
+
+  // least significant digit first, into bytes 4..0 of every lane
+  auto digits = _mm256_setzero_si256();
+  for (int i = 4; i >= 0; i--) {
+    auto const quotient =
+        _mm256_srli_epi64(_mm256_mul_epu32(parts, reciprocal), 36);
+    auto const digit =
+        _mm256_sub_epi64(parts, _mm256_mul_epu32(quotient, base));
+    digits = _mm256_or_si256(
+        digits, _mm256_sll_epi64(digit, _mm_cvtsi32_si128(8 * i)));
+    parts = quotient;
+  }
+
+  // digit -> '0'-'9', 'A'-'Z' (+7), 'a'-'z' (+6 more)
+  auto letters = _mm256_add_epi8(digits, _mm256_set1_epi8('0'));
+  letters = _mm256_add_epi8(
+      letters,
+      _mm256_and_si256(_mm256_cmpgt_epi8(digits, _mm256_set1_epi8(9)),
+                       _mm256_set1_epi8(7)));
+  letters = _mm256_add_epi8(
+      letters,
+      _mm256_and_si256(_mm256_cmpgt_epi8(digits, _mm256_set1_epi8(35)),
+                       _mm256_set1_epi8(6)));
+
+  alignas(32) char lanes[32];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), letters);
+  chars[0] = detail::kBase62Alphabet[firstTop / detail::k62Pow5];
+  std::memcpy(chars + 1, lanes, 5);
+  std::memcpy(chars + 6, lanes + 8, 5);
+  chars[kBase62Size] = detail::kBase62Alphabet[secondTop / detail::k62Pow5];
+  std::memcpy(chars + kBase62Size + 1, lanes + 16, 5);
+  std::memcpy(chars + kBase62Size + 6, lanes + 24, 5);
+}
+
+__attribute__((target("avx2"))) inline void encodeBase62(
+    std::span<u64 const> snowflakes, std::span<char> out) noexcept {
+  auto const count = std::size(snowflakes);
+  std::size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    toBase62Pair(snowflakes[i], snowflakes[i + 1],
+                 std::data(out) + i * kBase62Size);
+  }
+  scalar::encodeBase62(snowflakes.subspan(i), out.subspan(i * kBase62Size));
+}
+
+// 16 low digits: 4 groups below 10^4 as 32 bit fixed point fractions
+// (g * ceil(2^32 / 10^4)), every multiplication by 10 moves the next digit
+// above bit 32 in the 4 lanes at once
+__attribute__((target("avx2"))) inline std::size_t encodeDecimal(
+    std::span<u64 const> snowflakes, std::span<char> out,
+    char separator) noexcept {
+  auto const fractionMask = _mm256_set1_epi64x(0xffffffffll);
+  auto const zeros = _mm_set1_epi8('0');
+  auto const gather = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+  auto* end = std::data(out);
+  for (auto const snowflake : snowflakes) {
+    if (snowflake < 10'000ull) {
+      end = toChars(snowflake, end);
+      *end++ = separator;
+      continue;
+    }
+
+    auto const top = snowflake / 10'000'000'000'000'000ull;
+    auto const low = snowflake % 10'000'000'000'000'000ull;
+    auto const high8 = static_cast<std::uint32_t>(low / 100'000'000ull);
+    auto const low8 = static_cast<std::uint32_t>(low % 100'000'000ull);
+    auto fractions = _mm256_mul_epu32(
+        _mm256_setr_epi64x(high8 / 10'000u, high8 % 10'000u, low8 / 10'000u,
+                           low8 % 10'000u),
+        _mm256_set1_epi64x(429'497ll));
+
+    auto digits = _mm256_setzero_si256();
+    for (int i = 0; i < 4; i++) {
+      fractions = _mm256_add_epi64(_mm256_slli_epi64(fractions, 3),
+                                   _mm256_slli_epi64(fractions, 1));
+      digits = _mm256_or_si256(
+          digits, _mm256_sll_epi64(_mm256_srli_epi64(fractions, 32),
+                                   _mm_cvtsi32_si128(8 * i)));
+      fractions = _mm256_and_si256(fractions, fractionMask);
+    }
+    // the low 4 bytes of every lane -> 16 contiguous chars
+    auto const chars = _mm_add_epi8(
+        _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(digits, gather)),
+        zeros);
+
+    char buffer[32];
+    auto* const first = buffer + 16;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(first), chars);
+    auto* begin = first;
+    if (top != 0ull) {
+      // up to 4 more digits in front (2^64 < 1845 * 10^16)
+      auto* const topEnd = toChars(top, buffer);
+      auto const topSize = static_cast<std::size_t>(topEnd - buffer);
+      begin = first - topSize;
+      std::memmove(begin, buffer, topSize);
+    } else {
+      // skip the leading zeros, at least 5 digits remain
+      auto const zeroMask = static_cast<unsigned>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(chars, zeros)));
+      begin += std::countr_one(zeroMask);
+    }
+    auto const size = static_cast<std::size_t>(first + 16 - begin);
+    std::memcpy(end, begin, size);
+    end += size;
+    *end++ = separator;
+  }
+  return static_cast<std::size_t>(end - std::data(out));
+}
+}  // namespace avx2
+#endif
+
+namespace detail {
+// the base32 kernels also need bmi2 (pdep/pext)
+inline bool hasAvx2() noexcept {
+#if defined(__x86_64__)
+  static bool const kHasAvx2 = []() {
+    __builtin_cpu_init();
+    return (bulk::detectIsa() != bulk::Isa::kScalar) &&
+           __builtin_cpu_supports("bmi2");
+  }();
+  return kHasAvx2;
+#else
+  return false;
+#endif
+}
+}  // namespace detail
+
+inline void encodeBase32(std::span<u64 const> snowflakes,
+                         std::span<char> out) noexcept {
+#if defined(__x86_64__)
+  if (detail::hasAvx2()) {
+    return avx2::encodeBase32(snowflakes, out);
+  }
+#endif
+  scalar::encodeBase32(snowflakes, out);
+}
+
+inline bool decodeBase32(std::span<char const> text,
+                         std::span<u64> snowflakes) noexcept {
+#if defined(__x86_64__)
+  if (detail::hasAvx2()) {
+    return avx2::decodeBase32(text, snowflakes);
+  }
+#endif
+  return scalar::decodeBase32(text, snowflakes);
+}
+
+inline void encodeBase62(std::span<u64 const> snowflakes,
+                         std::span<char> out) noexcept {
+#if defined(__x86_64__)
+  if (detail::hasAvx2()) {
+    return avx2::encodeBase62(snowflakes, out);
+  }
+#endif
+  scalar::encodeBase62(snowflakes, out);
+}
+
+inline bool decodeBase62(std::span<char const> text,
+                         std::span<u64> snowflakes) noexcept {
+  return scalar::decodeBase62(text, snowflakes);
+}
+
+inline std::size_t encodeDecimal(std::span<u64 const> snowflakes,
+                                 std::span<char> out,
+                                 char separator = '\n') noexcept {
+#if defined(__x86_64__)
+  if (detail::hasAvx2()) {
+    return avx2::encodeDecimal(snowflakes, out, separator);
+  }
+#endif
+  return scalar::encodeDecimal(snowflakes, out, separator);
+}
+
+}  // namespace text
+}  // namespace lf
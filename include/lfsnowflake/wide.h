@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "lockfree.h"
+
+namespace lf {
+namespace wide {
+
+// 128 bit snowflakes for more than 4,096 ids per millisecond and MPID.
+// FORMAT (msb first):
+// high: |-- 41 bit timestamp [ticks] --|-- 22 bit sequence --|
+// low:  |---------------------- 64 bit MPID --------------------|
+// high is a snowflake of a Layout without MPID bits, issued by an
+// lf::BasicGenerator of that layout, so ids sort by time and sequence first
+// and a single 64 bit atomic still issues them (up to 4,194,304 ids per tick)
+
+template <u64 Epoch = 0ull, typename TickUnit = std::chrono::milliseconds>
+using WideLayout = Layout<41ull, 0ull, 22ull, Epoch, TickUnit>;
+
+using DefaultWideLayout = WideLayout<>;
+
+inline constexpr u64 kSequenceBits = DefaultWideLayout::kSequenceBits;
+inline constexpr u64 kSequenceCount = DefaultWideLayout::kSequenceCount;
+inline constexpr u64 kSequenceMask = DefaultWideLayout::kSequenceMask;
+
+struct Id {
+  u64 high;
+  u64 low;
+
+  friend constexpr auto operator<=>(Id const&, Id const&) noexcept = default;
+};
+
+template <typename LayoutT = DefaultWideLayout>
+constexpr Id make(u64 timestamp, u64 mpid, u64 sequence) noexcept {
+  return {LayoutT::make(timestamp, 0ull, sequence), mpid};
+}
+
+template <typename LayoutT = DefaultWideLayout>
+constexpr u64 getTimestamp(Id id) noexcept {
+  return LayoutT::getTimestamp(id.high);
+}
+
+constexpr u64 getMpid(Id id) noexcept { return id.low; }
+
+template <typename LayoutT = DefaultWideLayout>
+constexpr u64 getSequence(Id id) noexcept {
+  return LayoutT::getSequence(id.high);
+}
+
+static_assert(getSequence(make(5ull, 7ull, 9ull)) == 9ull);
+static_assert(getTimestamp(make(5ull, 7ull, 9ull)) == 5ull);
+static_assert(make(1ull, 0ull, 0ull) > make(0ull, 1ull, kSequenceMask));
+
+// lf::BasicGenerator of a wide layout, the MPID is carried in the low word
+template <typename Clock = clock::Default,
+          typename LayoutT = DefaultWideLayout>
+class BasicGenerator {
+ public:
+  static_assert(LayoutT::kMpidBits == 0ull,
+                "the MPID is the low word, not a field of the high word");
+
+  constexpr BasicGenerator() noexcept = default;
+
+  BasicGenerator(BasicGenerator const&) = delete;
+  BasicGenerator& operator=(BasicGenerator const&) = delete;
+
+  // {0, 0} once the tick's sequence is used up, same as lf::get
+  Id get(u64 mpid) noexcept {
+    auto const high = m_Generator.get(0ull);
+    return {high, (high != 0ull) ? mpid : 0ull};
+  }
+
+  // fills out with up to n ids of a single tick, returns the number written
+  // (0 if the sequence is exhausted for this tick)
+  std::size_t getBatch(u64 mpid, u64 n, std::span<Id> out) noexcept {
+    auto const reservation = m_Generator.reserve(
+        std::min<u64>(n, static_cast<u64>(std::size(out))));
+
+    auto const base = LayoutT::encode(0ull, reservation.sequence);
+    for (auto i = 0ull; i < reservation.count; i++) {
+      out[i] = {base + i, mpid};
+    }
+    return static_cast<std::size_t>(reservation.count);
+  }
+
+ private:
+  lf::BasicGenerator<Clock, LayoutT> m_Generator;
+};
+
+using Generator = BasicGenerator<>;
+
+// process-wide generator backing the free functions
+inline Generator g_Generator;
+
+inline Id get(u64 mpid) noexcept { return g_Generator.get(mpid); }
+
+inline std::size_t getBatch(u64 mpid, u64 n, std::span<Id> out) noexcept {
+  return g_Generator.getBatch(mpid, n, out);
+}
+
+}  // namespace wide
+}  // namespace lf
@@ -1,4 +1,5 @@
 #include <argh.h>
+#include <lfsnowflake/lockfree.h>
 
 #include <array>
 #include <chrono>
@@ -8,8 +9,21 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "algorithm/Burst.h"
+#include "Affinity.h"
+#include "ArchiveTest.h"
+#include "BulkTest.h"
+#include "ClockTest.h"
+#include "CoroutineTest.h"
+#include "IpcTest.h"
+#include "SharedMemoryTest.h"
+#include "SoakTest.h"
+#include "SortTest.h"
+#include "TextTest.h"
+#include "WideTest.h"
 #include "algorithm/Lockfree.h"
 #include "algorithm/Locking.h"
+#include "algorithm/Prefetch.h"
 #include "src/SnowflakeTest.h"
 
 /*main is a test for the snowflake generation*/
@@ -26,8 +40,12 @@ auto main(int argc, char** argv) -> int {
   cmdl.add_param({"-t"});
   cmdl.add_param({"-i"});
   cmdl.add_param({"-I"});
+  cmdl.add_param({"-T"});
   cmdl.add_param({"-lf"});
-  cmdl.parse(argv, argc);
+  cmdl.add_param({"-s"});
+  cmdl.add_param({"-a"});
+  cmdl.add_param({"-co"});
+  cmdl.parse(argc, argv);
 
   if (cmdl[{"-h", "--help"}]) {
     std::cout << "Options List:\n";
@@ -35,7 +53,107 @@ auto main(int argc, char** argv) -> int {
     std::cout << "-t <n> Number of threads to use, default: 4\n";
     std::cout << "-i <n> Number of iterations per thread, default: 1024\n";
     std::cout << "-I <n> Number of total iterations, default: 4096\n";
+    std::cout << "-T <n> Sweep thread counts from 1 to n, overrides -t\n";
     std::cout << "-lf    Use lock free algorithm, default: use locking\n";
+    std::cout << "-clk   Compare the clock sources of lf::Generator\n";
+    std::cout << "-a <p> Pin the threads with placement p: compact, scatter,\n"
+                 "       smt (one per core) or node (first NUMA node only)\n";
+    std::cout << "-A     Sweep every test over all the placements of -a\n";
+    std::cout << "-l     Report per call latency percentiles [ns]\n";
+    std::cout << "-perf  Report hardware events per id (perf_event_open)\n";
+    std::cout << "-bulk  Measure lf::bulk encode/decode throughput [GB/s] of\n"
+                 "       -I ids (default: 2^24)\n";
+    std::cout << "-arc   Measure lf::archive compression ratio, encode/decode\n"
+                 "       throughput [GB/s] and a range query over -I ids of\n"
+                 "       lf::get on -t threads (default: 2^22)\n";
+    std::cout << "-txt   Measure lf::text base32/base62/decimal encode and\n"
+                 "       decode throughput of -I ids (default: 2^22)\n";
+    std::cout << "-sort  Compare lf::sort radix sort and loser tree merge of\n"
+                 "       -t runs with std::sort, -I ids (default: 10^8)\n";
+    std::cout << "-shm   Compare lf::SharedGenerator across -t processes with\n"
+                 "       lf::get across -t threads\n";
+    std::cout << "-ipc   Compare lf::ipc clients of an in-process id server\n"
+                 "       (per id, batched, pipelined) with lf::v4d::get\n";
+    std::cout << "-ring  Compare consumers of pre-generated id rings (SPSC\n"
+                 "       per thread, shared MPMC) with lf::get, use with -l\n";
+    std::cout << "-wide  Compare 128 bit lf::wide ids (22 bit sequence) with\n"
+                 "       lf::v4d and lf::v5a\n";
+    std::cout << "-co <n> Run n coroutines per thread awaiting lf::nextId and\n"
+                 "       lf::nextIds on a reference executor\n";
+    std::cout << "-s <n> Soak lf::get for n seconds on -t threads, verifying\n"
+                 "       the ids while streaming them in constant memory\n";
+    return 0;
+  }
+
+  if (cmdl["bulk"]) {
+    auto idCount = 1ull << 24;
+    if (cmdl("I")) {
+      cmdl("I") >> idCount;
+    }
+
+    BulkTest test(idCount);
+    test.runTest();
+    test.runAnalysis();
+    return 0;
+  }
+
+  if (cmdl["arc"]) {
+    auto idCount = 1ull << 22;
+    if (cmdl("I")) {
+      cmdl("I") >> idCount;
+    }
+    auto threadCount = 4ull;
+    if (cmdl("t")) {
+      cmdl("t") >> threadCount;
+    }
+
+    ArchiveTest test(idCount, threadCount);
+    test.runTest();
+    test.runAnalysis();
+    return 0;
+  }
+
+  if (cmdl["txt"]) {
+    auto idCount = 1ull << 22;
+    if (cmdl("I")) {
+      cmdl("I") >> idCount;
+    }
+
+    TextTest test(idCount);
+    test.runTest();
+    test.runAnalysis();
+    return 0;
+  }
+
+  if (cmdl["sort"]) {
+    auto idCount = 100'000'000ull;
+    if (cmdl("I")) {
+      cmdl("I") >> idCount;
+    }
+    auto threadCount = 4ull;
+    if (cmdl("t")) {
+      cmdl("t") >> threadCount;
+    }
+
+    SortTest test(idCount, threadCount);
+    test.runTest();
+    test.runAnalysis();
+    return 0;
+  }
+
+  if (cmdl("s")) {
+    auto soakDuration_s = 0ull;
+    cmdl("s") >> soakDuration_s;
+    auto threadCount = 4ull;
+    if (cmdl("t")) {
+      cmdl("t") >> threadCount;
+    }
+
+    using namespace std::literals::string_view_literals;
+    SoakTest test("lf::get"sv, lf::get, threadCount,
+                  std::chrono::seconds(soakDuration_s));
+    test.runTest();
+    test.runAnalysis();
     return 0;
   }
 
@@ -45,68 +163,276 @@ auto main(int argc, char** argv) -> int {
     useLockfree = true;
   }
 
+  bool useClocks = false;
+  if (cmdl["clk"]) {
+    useClocks = true;
+  }
+
+  bool useSharedMemory = false;
+  if (cmdl["shm"]) {
+    useSharedMemory = true;
+  }
+
+  bool useIpc = false;
+  if (cmdl["ipc"]) {
+    useIpc = true;
+  }
+
+  bool useRings = false;
+  if (cmdl["ring"]) {
+    useRings = true;
+  }
+
+  bool useWide = false;
+  if (cmdl["wide"]) {
+    useWide = true;
+  }
+
+  auto coroutineCount = 0ull;
+  if (cmdl("co")) {
+    cmdl("co") >> coroutineCount;
+  }
+
+  ISnowflakeTest::Options options;
+  if (cmdl["l"]) {
+    options.recordLatency = true;
+  }
+  if (cmdl["perf"]) {
+    options.countEvents = true;
+  }
+
+  std::vector<affinity::Placement> placements = {affinity::Placement::kNone};
+  if (cmdl("a")) {
+    std::string placementName;
+    cmdl("a") >> placementName;
+    if (!affinity::parse(placementName, placements.front())) {
+      std::cout << "Unknown placement: " << placementName << std::endl;
+      return -1;
+    }
+  }
+  if (cmdl["A"]) {
+    placements.assign(std::begin(affinity::kPinnedPlacements),
+                      std::end(affinity::kPinnedPlacements));
+  }
+
   auto iterationCount = 1024ull;
   if (cmdl("i")) {
     cmdl("i") >> iterationCount;
   }
 
-  auto threadCount = 4ull;
+  auto defaultThreadCount = 4ull;
   if (cmdl("t")) {
-    cmdl("t") >> threadCount;
+    cmdl("t") >> defaultThreadCount;
   }
 
+  auto totalIterationCount = 0ull;
   if (cmdl("I")) {
-    cmdl("I") >> iterationCount;
-    iterationCount = iterationCount / threadCount;
+    cmdl("I") >> totalIterationCount;
   }
 
-  if (useLockfree) {
-    using namespace std::literals::string_view_literals;
-    std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
-        std::make_unique<SnowFlakeTest<lockfree::v0::get>>(
-            "lockfree::v0a::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v1::get>>(
-            "lockfree::v1a::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v2a::get>>(
-            "lockfree::v2a::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v2b::get>>(
-            "lockfree::v2b::get"sv, threadCount, iterationCount),
-
-        std::make_unique<SnowFlakeTest<lockfree::v3a::get>>(
-            "lockfree::v3a::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v3b::get>>(
-            "lockfree::v3b::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v3c::get>>(
-            "lockfree::v3c::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v3d::get>>(
-            "lockfree::v3d::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v3::get>>(
-            "lockfree::v3::get"sv, threadCount, iterationCount),
-
-        // make sequence reset on new millisecond
-        std::make_unique<SnowFlakeTest<lockfree::v4a::get>>(
-            "lockfree::v4a::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v4b::get>>(
-            "lockfree::v4b::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v4c::get>>(
-            "lockfree::v4c::get"sv, threadCount, iterationCount),
-        std::make_unique<SnowFlakeTest<lockfree::v4d::get>>(
-            "lockfree::v4d::get"sv, threadCount, iterationCount),
-    };
-
-    for (auto& test : tests) {
-      test->runTest();
-      test->runAnalysis();
+  // run every test once per thread count in [minThreadCount, maxThreadCount]
+  auto minThreadCount = defaultThreadCount;
+  auto maxThreadCount = defaultThreadCount;
+  if (cmdl("T")) {
+    cmdl("T") >> maxThreadCount;
+    minThreadCount = 1ull;
+  }
+
+  for (auto const placement : placements) {
+    options.cpus = affinity::cpuOrder(placement);
+    options.placement = {};
+    if (!options.cpus.empty()) {
+      options.placement = affinity::toString(placement);
+    } else if (placement != affinity::Placement::kNone) {
+      std::cout << "CPU topology unavailable, threads are not pinned"
+                << std::endl;
     }
-  } else {
-    using namespace std::literals::string_view_literals;
-    std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
-        std::make_unique<SnowFlakeTest<locking::v1::get>>("locking::v1::get"sv, threadCount, iterationCount),
-    };
 
-    for (auto& test : tests) {
-      test->runTest();
-      test->runAnalysis();
+    for (auto threadCount = minThreadCount; threadCount <= maxThreadCount;
+         threadCount++) {
+      if (totalIterationCount != 0ull) {
+        iterationCount = totalIterationCount / threadCount;
+      }
+
+      if (useWide) {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<SnowFlakeTest<lf::v4d::get>>(
+                "lf::v4d::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lf::v5a::get>>(
+                "lf::v5a::get"sv, threadCount, iterationCount),
+            std::make_unique<WideTest>("lf::wide::get"sv, threadCount,
+                                       iterationCount, 1ull),
+            // batches of 64 per thread
+            std::make_unique<WideTest>("lf::wide::getBatch"sv, threadCount,
+                                       iterationCount, 64ull),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      } else if (useRings) {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<SnowFlakeTest<lf::get>>("lf::get"sv, threadCount,
+                                                     iterationCount),
+            std::make_unique<SnowFlakeTest<prefetch::getSpsc>>(
+                "lf::IdPrefetcher<SpscRing>"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<prefetch::getMpmc>>(
+                "lf::IdPrefetcher<MpmcRing>"sv, threadCount, iterationCount),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      } else if (useIpc) {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<SnowFlakeTest<lf::v4d::get>>(
+                "lf::v4d::get"sv, threadCount, iterationCount),
+            // one round trip per id
+            std::make_unique<IpcTest>("lf::ipc::Client::get"sv, threadCount,
+                                      iterationCount, 1ull, 1ull),
+            std::make_unique<IpcTest>("lf::ipc::Client::getBatch(64)"sv,
+                                      threadCount, iterationCount, 64ull, 1ull),
+            // 8 requests of 64 ids in flight
+            std::make_unique<IpcTest>("lf::ipc::Client::getPipelined(64x8)"sv,
+                                      threadCount, iterationCount, 64ull, 8ull),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      } else if (useSharedMemory) {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<SnowFlakeTest<lf::get>>("lf::get"sv, threadCount,
+                                                     iterationCount),
+            // one process per thread sharing a single sequence
+            std::make_unique<SharedMemoryTest>("lf::SharedGenerator"sv,
+                                               threadCount, iterationCount),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      } else if (coroutineCount != 0ull) {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<CoroutineTest>("lf::nextId"sv, threadCount,
+                                            iterationCount, coroutineCount,
+                                            1ull),
+            // batches of 16 ids per co_await
+            std::make_unique<CoroutineTest>("lf::nextIds"sv, threadCount,
+                                            iterationCount, coroutineCount,
+                                            16ull),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      } else if (useClocks) {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<ClockTest<lf::clock::Steady>>(
+                "lf::clock::Steady"sv, threadCount, iterationCount),
+            std::make_unique<ClockTest<lf::clock::MonotonicCoarse>>(
+                "lf::clock::MonotonicCoarse"sv, threadCount, iterationCount),
+            std::make_unique<ClockTest<lf::clock::RealtimeCoarse>>(
+                "lf::clock::RealtimeCoarse"sv, threadCount, iterationCount),
+            std::make_unique<ClockTest<lf::clock::Tsc>>(
+                "lf::clock::Tsc"sv, threadCount, iterationCount),
+            // background thread publishing the millisecond
+            std::make_unique<ClockTest<lf::clock::Ticker<lf::clock::Steady>>>(
+                "lf::clock::Ticker<Steady>"sv, threadCount, iterationCount),
+            std::make_unique<ClockTest<lf::clock::Ticker<lf::clock::Tsc>>>(
+                "lf::clock::Ticker<Tsc>"sv, threadCount, iterationCount),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      } else if (useLockfree) {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<SnowFlakeTest<lockfree::v0::get>>(
+                "lockfree::v0a::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v1::get>>(
+                "lockfree::v1a::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v2a::get>>(
+                "lockfree::v2a::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v2b::get>>(
+                "lockfree::v2b::get"sv, threadCount, iterationCount),
+
+            std::make_unique<SnowFlakeTest<lockfree::v3a::get>>(
+                "lockfree::v3a::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v3b::get>>(
+                "lockfree::v3b::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v3c::get>>(
+                "lockfree::v3c::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v3d::get>>(
+                "lockfree::v3d::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v3::get>>(
+                "lockfree::v3::get"sv, threadCount, iterationCount),
+
+            // make sequence reset on new millisecond
+            std::make_unique<SnowFlakeTest<lockfree::v4a::get>>(
+                "lockfree::v4a::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v4b::get>>(
+                "lockfree::v4b::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v4c::get>>(
+                "lockfree::v4c::get"sv, threadCount, iterationCount),
+            std::make_unique<SnowFlakeTest<lockfree::v4d::get>>(
+                "lockfree::v4d::get"sv, threadCount, iterationCount),
+
+            // library implementations
+            std::make_unique<SnowFlakeTest<lf::v4d::get>>(
+                "lf::v4d::get"sv, threadCount, iterationCount),
+            // park on sequence exhaustion instead of returning 0
+            std::make_unique<SnowFlakeTest<lf::v4d::getBlocking>>(
+                "lf::v4d::getBlocking"sv, threadCount, iterationCount),
+            // borrow up to 4 ms ahead of the clock before returning 0
+            std::make_unique<SnowFlakeTest<burst::get<4ull>>>(
+                "lf::Generator (burst credit 4)"sv, threadCount,
+                iterationCount),
+            // thread local sequence leasing
+            std::make_unique<SnowFlakeTest<lf::v5a::get>>(
+                "lf::v5a::get"sv, threadCount, iterationCount),
+            // per shard sequence numbers
+            std::make_unique<SnowFlakeTest<lf::v6a::get>>(
+                "lf::v6a::get"sv, threadCount, iterationCount),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      } else {
+        using namespace std::literals::string_view_literals;
+        std::initializer_list<std::unique_ptr<ISnowflakeTest>> tests = {
+            std::make_unique<SnowFlakeTest<locking::v1::get>>(
+                "locking::v1::get"sv, threadCount, iterationCount),
+        };
+
+        for (auto& test : tests) {
+          test->setOptions(options);
+          test->runTest();
+          test->runAnalysis();
+        }
+      }
     }
   }
 
@@ -0,0 +1,190 @@
+#include "Affinity.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace affinity {
+namespace {
+
+struct Cpu {
+  int id;
+  int package;
+  int core;
+  int node;
+  // rank of this logical cpu among the siblings of its core
+  int smtIndex;
+  // rank of this core among the cores of its NUMA node
+  int coreIndex;
+};
+
+int readInt(std::string const& path, int fallback) {
+  std::ifstream file(path);
+  int value = fallback;
+  if (!(file >> value)) {
+    return fallback;
+  }
+  return value;
+}
+
+// parses a sysfs cpu or node list (ie. "0-3,8-11")
+std::vector<int> readIdList(std::string const& path) {
+  std::vector<int> cpus;
+  std::ifstream file(path);
+  std::string range;
+  while (std::getline(file, range, ',')) {
+    auto const dash = range.find('-');
+    try {
+      auto const first = std::stoi(range.substr(0, dash));
+      auto const last = (dash == std::string::npos)
+                            ? first
+                            : std::stoi(range.substr(dash + 1));
+      for (auto cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    } catch (...) {
+      return {};
+    }
+  }
+  return cpus;
+}
+
+std::vector<Cpu> readTopology() {
+  std::vector<Cpu> cpus;
+#if defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return {};
+  }
+
+  for (int id = 0; id < CPU_SETSIZE; id++) {
+    if (!CPU_ISSET(id, &allowed)) {
+      continue;
+    }
+    auto const topology =
+        "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+    cpus.push_back({id, readInt(topology + "physical_package_id", 0),
+                    readInt(topology + "core_id", id), 0, 0, 0});
+  }
+
+  // node ids need not be contiguous, machines without NUMA support have no
+  // node list and all their cpus stay in node 0
+  for (auto const node : readIdList("/sys/devices/system/node/online")) {
+    auto const nodeCpus = readIdList("/sys/devices/system/node/node" +
+                                     std::to_string(node) + "/cpulist");
+    for (auto& cpu : cpus) {
+      if (std::find(std::begin(nodeCpus), std::end(nodeCpus), cpu.id) !=
+          std::end(nodeCpus)) {
+        cpu.node = node;
+      }
+    }
+  }
+
+  // siblings share package and core id, cores are ranked by their first cpu
+  std::sort(std::begin(cpus), std::end(cpus), [](Cpu const& a, Cpu const& b) {
+    return std::tie(a.node, a.package, a.core, a.id) <
+           std::tie(b.node, b.package, b.core, b.id);
+  });
+  for (std::size_t i = 1; i < std::size(cpus); i++) {
+    auto const& previous = cpus[i - 1];
+    auto& cpu = cpus[i];
+    bool const isSameCore = (cpu.package == previous.package) &&
+                            (cpu.core == previous.core);
+    cpu.smtIndex = isSameCore ? previous.smtIndex + 1 : 0;
+    cpu.coreIndex = (cpu.node != previous.node) ? 0
+                    : isSameCore               ? previous.coreIndex
+                                               : previous.coreIndex + 1;
+  }
+#endif
+  return cpus;
+}
+
+}  // namespace
+
+std::string_view toString(Placement placement) noexcept {
+  switch (placement) {
+    case Placement::kCompact:
+      return "compact";
+    case Placement::kScatter:
+      return "scatter";
+    case Placement::kSmt:
+      return "smt";
+    case Placement::kNode:
+      return "node";
+    default:
+      return "none";
+  }
+}
+
+bool parse(std::string_view name, Placement& placement) noexcept {
+  for (auto const candidate : {Placement::kNone, Placement::kCompact,
+                               Placement::kScatter, Placement::kSmt,
+                               Placement::kNode}) {
+    if (name == toString(candidate)) {
+      placement = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<int> cpuOrder(Placement placement) {
+  if (placement == Placement::kNone) {
+    return {};
+  }
+
+  // compact order: node, core, sibling
+  auto cpus = readTopology();
+  if (cpus.empty()) {
+    return {};
+  }
+
+  switch (placement) {
+    case Placement::kScatter:
+      std::stable_sort(std::begin(cpus), std::end(cpus),
+                       [](Cpu const& a, Cpu const& b) {
+                         return std::tie(a.smtIndex, a.coreIndex, a.node) <
+                                std::tie(b.smtIndex, b.coreIndex, b.node);
+                       });
+      break;
+    case Placement::kSmt:
+      std::erase_if(cpus, [](Cpu const& cpu) { return cpu.smtIndex != 0; });
+      break;
+    case Placement::kNode: {
+      auto const node = cpus.front().node;
+      std::erase_if(cpus, [node](Cpu const& cpu) { return cpu.node != node; });
+      break;
+    }
+    default:
+      break;
+  }
+
+  std::vector<int> order;
+  for (auto const& cpu : cpus) {
+    order.push_back(cpu.id);
+  }
+  return order;
+}
+
+bool pin(std::jthread& thread, int cpu) noexcept {
+#if defined(__linux__)
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) ==
+         0;
+#else
+  (void)thread;
+  (void)cpu;
+  return false;
+#endif
+}
+
+}  // namespace affinity
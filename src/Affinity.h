@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace affinity {
+
+// thread placements, the test threads are pinned round robin to the cpus of
+// cpuOrder(placement)
+enum class Placement {
+  // not pinned, left to the scheduler
+  kNone,
+  // fill a NUMA node before the next one, SMT siblings next to each other
+  kCompact,
+  // round robin across NUMA nodes, one thread per core before the siblings
+  kScatter,
+  // one SMT sibling per core, compact across the cores
+  kSmt,
+  // compact, restricted to the NUMA node of the first allowed cpu
+  kNode,
+};
+
+inline constexpr std::array kPinnedPlacements = {
+    Placement::kCompact, Placement::kScatter, Placement::kSmt,
+    Placement::kNode};
+
+std::string_view toString(Placement placement) noexcept;
+// returns false on an unknown name
+bool parse(std::string_view name, Placement& placement) noexcept;
+
+// logical cpus allowed for this process in pinning order, empty for kNone or
+// when the topology can not be read (the threads then stay unpinned)
+std::vector<int> cpuOrder(Placement placement);
+
+// pins a thread to a single logical cpu, returns false on failure
+bool pin(std::jthread& thread, int cpu) noexcept;
+
+}  // namespace affinity
@@ -0,0 +1,166 @@
+#include "ArchiveTest.h"
+
+#include <lfsnowflake/archive.h>
+#include <lfsnowflake/lockfree.h>
+#include <lfsnowflake/sort.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+
+#include "Timing.h"
+
+namespace {
+using u64 = std::uint64_t;
+}  // namespace
+
+ArchiveTest::ArchiveTest(std::uint64_t t_idCount, std::uint64_t t_threadCount)
+    : idCount(t_idCount),
+      threadCount(std::max<std::uint64_t>(t_threadCount, 1ull)) {}
+
+void ArchiveTest::runTest() {
+  std::cout << "Running Test: lf::archive" << std::endl;
+
+  // the ids a SnowFlakeTest run of lf::get produces, merged in time order
+  std::vector<std::vector<u64>> threadIds(threadCount);
+  {
+    std::vector<std::jthread> jThreadPool;
+    for (auto i = 0ull; i < threadCount; i++) {
+      jThreadPool.emplace_back(
+          [&ids = threadIds[i], count = idCount / threadCount +
+                                        (i < idCount % threadCount)]() {
+            ids.resize(count);
+            for (auto& id : ids) {
+              while (id = lf::get(0ull), id == 0ull) {
+                std::this_thread::yield();
+              }
+            }
+          });
+    }
+  }
+  std::vector<std::span<u64 const>> runs(std::begin(threadIds),
+                                         std::end(threadIds));
+  std::vector<u64> ids(idCount);
+  lf::sort::merge(runs, ids);
+  threadIds.clear();
+
+  auto const byteCount = idCount * sizeof(u64);
+  std::vector<u64> copy(idCount);
+  copyRate_GBps = timing::bestRate_GBps(byteCount, [&]() {
+    std::memcpy(std::data(copy), std::data(ids), byteCount);
+  });
+
+  auto const isa = lf::bulk::detectIsa();
+  struct Kernel {
+    std::string_view name;
+    lf::bulk::Isa isa;
+    bool supported;
+  };
+  std::vector<Kernel> kernels = {
+      {"lf::archive::scalar", lf::bulk::Isa::kScalar, true},
+#if defined(__x86_64__) || defined(__i386__)
+      {"lf::archive::avx2", lf::bulk::Isa::kAvx2,
+       isa != lf::bulk::Isa::kScalar},
+#endif
+  };
+
+  std::vector<u64> encoded;
+  encoded.reserve(idCount + idCount / lf::archive::kBlockSize * 8);
+  results.clear();
+  for (auto const& kernel : kernels) {
+    if (!kernel.supported) {
+      continue;
+    }
+
+    auto const encodeRate = timing::bestRate_GBps(byteCount, [&]() {
+      encoded.clear();
+      for (auto i = 0ull; i < idCount; i += lf::archive::kBlockSize) {
+        lf::archive::encodeBlock(
+            std::span(ids).subspan(
+                i, std::min<std::size_t>(lf::archive::kBlockSize, idCount - i)),
+            encoded, kernel.isa);
+      }
+    });
+
+    // decoded blocks land in the copy, the padding of the last block needs
+    // room past the end
+    copy.resize(idCount + lf::archive::kBlockSize);
+    auto const decodeRate = timing::bestRate_GBps(byteCount, [&]() {
+      std::size_t offset = 0;
+      for (auto i = 0ull; i < idCount; i += lf::archive::kBlockSize) {
+        lf::archive::decodeBlock(std::data(encoded) + offset,
+                                 std::span(copy).subspan(i), kernel.isa);
+        offset += lf::archive::blockWordCount(std::data(encoded) + offset);
+      }
+    });
+    copy.resize(idCount);
+
+    results.push_back({kernel.name, encodeRate, decodeRate, copy == ids});
+  }
+  compressionRatio = (double)byteCount /
+                     (double)(std::size(encoded) * sizeof(u64));
+
+  // archive file, then the ids of the middle 1% of the time span
+  auto const path = "/tmp/lfsnowflake-archive-" + std::to_string(::getpid());
+  {
+    lf::archive::Writer<> writer(path.c_str());
+    writer.append(ids);
+    rangeValid = writer.finish();
+  }
+  lf::archive::Reader<> reader(path.c_str());
+  ::unlink(path.c_str());
+  if (!reader.isOpen() || ids.empty()) {
+    rangeValid = false;
+    return;
+  }
+
+  auto const first = lf::DefaultLayout::getTimestamp(ids.front());
+  auto const last = lf::DefaultLayout::getTimestamp(ids.back());
+  auto const from = first + (last - first) / 2;
+  auto const to = from + (last - first) / 100;
+
+  u64 expectedCount = 0ull;
+  for (auto const id : ids) {
+    auto const timestamp = lf::DefaultLayout::getTimestamp(id);
+    expectedCount += (timestamp >= from && timestamp <= to);
+  }
+
+  rangeIdCount = 0ull;
+  auto const begin = std::chrono::steady_clock::now();
+  rangeBlockCount =
+      reader.forEachInRange(from, to, [&](u64) { rangeIdCount++; });
+  auto const end = std::chrono::steady_clock::now();
+  rangeDuration_us = static_cast<u64>(
+      std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+          .count());
+  blockCount = reader.blockCount();
+  rangeValid = rangeValid && (rangeIdCount == expectedCount);
+}
+
+void ArchiveTest::runAnalysis() {
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "ID Count: " << idCount << std::endl;
+  std::cout << "Compression Ratio: " << compressionRatio << std::endl;
+  std::cout << "raw u64 copy: " << copyRate_GBps << " GB/s" << std::endl;
+  for (auto const& result : results) {
+    std::cout << result.name << " encode: " << result.encodeRate_GBps
+              << " GB/s, decode: " << result.decodeRate_GBps << " GB/s";
+    if (!result.valid) {
+      std::cout << " [FAILED]";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "Range (1% of the time span): " << rangeIdCount << " ids from "
+            << rangeBlockCount << "/" << blockCount << " blocks in "
+            << rangeDuration_us << " us";
+  if (!rangeValid) {
+    std::cout << " [FAILED]";
+  }
+  std::cout << std::endl;
+  std::cout << "--------------------------------" << std::endl << std::endl;
+}
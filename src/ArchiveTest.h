@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// compression ratio and encode/decode throughput of lf::archive blocks over
+// the merged ids of -t threads calling lf::get, and a timestamp range query
+// through the memory mapped lf::archive::Reader
+class ArchiveTest {
+ public:
+  explicit ArchiveTest(std::uint64_t t_idCount, std::uint64_t t_threadCount);
+
+  void runTest();
+  void runAnalysis();
+
+ private:
+  struct Result {
+    std::string_view name;
+    // bytes of raw u64 ids processed per second
+    double encodeRate_GBps;
+    double decodeRate_GBps;
+    bool valid;
+  };
+
+  std::uint64_t idCount;
+  std::uint64_t threadCount;
+
+  // raw bytes / encoded bytes
+  double compressionRatio = 0.0;
+  double copyRate_GBps = 0.0;
+  std::vector<Result> results;
+
+  // ids of the range query, blocks decoded for it and its duration
+  std::uint64_t rangeIdCount = 0ull;
+  std::uint64_t rangeBlockCount = 0ull;
+  std::uint64_t blockCount = 0ull;
+  std::uint64_t rangeDuration_us = 0ull;
+  bool rangeValid = false;
+};
@@ -0,0 +1,87 @@
+#include "BulkTest.h"
+
+#include <lfsnowflake/bulk.h>
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+
+#include "Timing.h"
+
+namespace {
+using u64 = std::uint64_t;
+using DecodeKernel = void (*)(std::span<u64 const>, std::span<u64>,
+                              std::span<u64>, std::span<u64>) noexcept;
+using EncodeKernel = void (*)(std::span<u64 const>, std::span<u64 const>,
+                              std::span<u64 const>, std::span<u64>) noexcept;
+}  // namespace
+
+BulkTest::BulkTest(std::uint64_t t_idCount) : idCount(t_idCount) {}
+
+void BulkTest::runTest() {
+  std::cout << "Running Test: lf::bulk" << std::endl;
+
+  // time ordered snowflakes with random mpids
+  std::mt19937_64 random(0ull);
+  snowflakes.resize(idCount);
+  for (auto i = 0ull; i < idCount; i++) {
+    snowflakes[i] = lf::DefaultLayout::make(i >> 12, random() % 1'024ull,
+                                            i bitand 4'095ull);
+  }
+
+  std::vector<u64> timestamps(idCount), mpids(idCount), sequences(idCount);
+  std::vector<u64> encoded(idCount);
+
+  struct Kernel {
+    std::string_view name;
+    DecodeKernel decode;
+    EncodeKernel encode;
+    bool supported;
+  };
+
+  auto const isa = lf::bulk::detectIsa();
+  std::vector<Kernel> kernels = {
+      {"lf::bulk::scalar", lf::bulk::scalar::decode<>,
+       lf::bulk::scalar::encode<>, true},
+#if defined(__x86_64__) || defined(__i386__)
+      {"lf::bulk::avx2", lf::bulk::avx2::decode<>, lf::bulk::avx2::encode<>,
+       isa != lf::bulk::Isa::kScalar},
+      {"lf::bulk::avx512", lf::bulk::avx512::decode<>,
+       lf::bulk::avx512::encode<>, isa == lf::bulk::Isa::kAvx512},
+#endif
+  };
+
+  auto const byteCount = idCount * sizeof(u64);
+  results.clear();
+  for (auto const& kernel : kernels) {
+    if (!kernel.supported) {
+      continue;
+    }
+
+    auto const decodeRate = timing::bestRate_GBps(byteCount, [&]() {
+      kernel.decode(snowflakes, timestamps, mpids, sequences);
+    });
+    auto const encodeRate = timing::bestRate_GBps(byteCount, [&]() {
+      kernel.encode(timestamps, mpids, sequences, encoded);
+    });
+
+    // round trip must reproduce the input
+    results.push_back({kernel.name, decodeRate, encodeRate,
+                       encoded == snowflakes});
+  }
+}
+
+void BulkTest::runAnalysis() {
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "ID Count: " << idCount << std::endl;
+  for (auto const& result : results) {
+    std::cout << result.name << " decode: " << result.decodeRate_GBps
+              << " GB/s, encode: " << result.encodeRate_GBps << " GB/s";
+    if (!result.valid) {
+      std::cout << " [FAILED]";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "--------------------------------" << std::endl << std::endl;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// throughput of the lf::bulk encode/decode kernels over arrays of snowflakes
+class BulkTest {
+ public:
+  explicit BulkTest(std::uint64_t t_idCount);
+
+  void runTest();
+  void runAnalysis();
+
+ private:
+  struct Result {
+    std::string_view name;
+    // bytes of snowflakes processed per second
+    double decodeRate_GBps;
+    double encodeRate_GBps;
+    bool valid;
+  };
+
+  std::uint64_t idCount;
+
+  std::vector<std::uint64_t> snowflakes;
+  std::vector<Result> results;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <lfsnowflake/lockfree.h>
+
+#include "SnowflakeTest.h"
+#include "algorithm/Clocks.h"
+
+// SnowFlakeTest of a generator on Clock that lives only for runTest(), so a
+// stateful clock (ie. the thread of lf::clock::Ticker) is stopped before the
+// next test starts
+template <typename Clock>
+struct ClockTest : SnowFlakeTest<clocks::get<Clock>> {
+  using SnowFlakeTest<clocks::get<Clock>>::SnowFlakeTest;
+
+  virtual void runTest() override {
+    lf::BasicGenerator<Clock> generator;
+    clocks::g_Generator<Clock> = &generator;
+    // returns once the test threads are joined
+    SnowFlakeTest<clocks::get<Clock>>::runTest();
+    clocks::g_Generator<Clock> = nullptr;
+  }
+};
@@ -0,0 +1,111 @@
+#include "CoroutineTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+void Executor::spawn(Task task) {
+  task.handle.promise().executor = this;
+  ready.push_back(task.handle);
+  liveCount++;
+}
+
+void Executor::run() {
+  auto const schedule = [this](std::coroutine_handle<> handle) {
+    ready.push_back(handle);
+  };
+
+  while (liveCount != 0ull) {
+    if (!ready.empty()) {
+      auto const handle = ready.front();
+      ready.pop_front();
+      handle.resume();
+      continue;
+    }
+    if (edgeNotifier.poll(schedule) == 0) {
+      std::this_thread::sleep_for(kIdleInterval);
+    }
+  }
+}
+
+CoroutineTest::CoroutineTest(std::string_view t_name,
+                             std::uint64_t t_threadCount,
+                             std::uint64_t t_iterationCount,
+                             std::uint64_t t_coroutineCount,
+                             std::uint64_t t_batchSize)
+    : ISnowflakeTest(t_name, t_threadCount, t_iterationCount),
+      coroutineCount(std::max<std::uint64_t>(t_coroutineCount, 1ull)),
+      batchSize(std::max<std::uint64_t>(t_batchSize, 1ull)) {}
+
+Executor::Task CoroutineTest::generate(Executor& executor, IdCursor& cursor,
+                                       std::uint64_t batchSize) {
+  auto const ids = cursor.ids;
+  while (cursor.next < std::size(ids)) {
+    if (batchSize == 1ull) {
+      // stored as soon as it is issued, before another coroutine runs
+      auto const id = co_await lf::nextId(0ull, executor.notifier());
+      if (cursor.next < std::size(ids)) {
+        ids[cursor.next++] = id;
+      }
+    } else if (cursor.isBatchPending) {
+      // the parked batch holds ids issued before the next edge
+      co_await executor.nextEdge();
+      continue;
+    } else {
+      // the batch claims its place before the first id is issued
+      auto const count =
+          std::min<std::size_t>(batchSize, std::size(ids) - cursor.next);
+      auto const begin = cursor.next;
+      cursor.next += count;
+      cursor.isBatchPending = true;
+      co_await lf::nextIds(0ull, ids.subspan(begin, count),
+                           executor.notifier());
+      cursor.isBatchPending = false;
+    }
+    co_await executor.yield();
+  }
+}
+
+void CoroutineTest::runTest() {
+  std::vector<std::jthread> jThreadPool;
+
+  std::cout << "Running Test: " << name << " (" << coroutineCount
+            << " coroutines/thread)" << std::endl;
+
+  std::atomic_flag flag(false);
+  std::atomic<std::uint64_t> counter(0);
+
+  workspaces.resize(threadCount);
+  for (auto& workspace : workspaces) {
+    workspace.idSequence.resize(iterationCount);
+    auto callable = [this, &flag, &counter](Workspace& workspace) -> void {
+      // the executor is single threaded: the coroutines append to the
+      // thread's ids through one cursor, in the order the ids are issued
+      Executor executor;
+      IdCursor cursor{workspace.idSequence};
+      for (auto i = 0ull; i < std::min(coroutineCount, iterationCount); i++) {
+        executor.spawn(generate(executor, cursor, batchSize));
+      }
+
+      // wait for thread synchronization
+      counter.fetch_add(1ull, std::memory_order_acq_rel);
+      flag.wait(false, std::memory_order_acquire);
+
+      const auto begin = std::chrono::steady_clock::now();
+      executor.run();
+      const auto end = std::chrono::steady_clock::now();
+      workspace.duration_ns = end - begin;
+    };
+
+    jThreadPool.emplace_back(callable, std::ref(workspace));
+  }
+
+  // synchronize threads
+  while (counter.load(std::memory_order_acquire) != threadCount) {
+    std::this_thread::yield();
+  }
+  flag.test_and_set(std::memory_order_release);
+  flag.notify_all();
+}
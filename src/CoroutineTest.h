@@ -0,0 +1,116 @@
+#pragma once
+
+#include <lfsnowflake/coroutine.h>
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+#include "ISnowflakeTest.h"
+
+// single threaded reference executor: a FIFO of ready coroutines, coroutines
+// parked on an exhausted millisecond are rescheduled through its notifier
+class Executor {
+ public:
+  // how long the executor sleeps when every coroutine is parked
+  static constexpr std::chrono::microseconds kIdleInterval{50};
+
+  // fire and forget coroutine, destroyed when it finishes
+  struct Task {
+    struct promise_type {
+      Executor* executor = nullptr;
+
+      Task get_return_object() noexcept {
+        return {std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      auto final_suspend() noexcept {
+        struct Finish {
+          bool await_ready() noexcept { return false; }
+          void await_suspend(
+              std::coroutine_handle<promise_type> handle) noexcept {
+            auto* executor = handle.promise().executor;
+            handle.destroy();
+            executor->liveCount--;
+          }
+          void await_resume() noexcept {}
+        };
+        return Finish{};
+      }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  void spawn(Task task);
+  // runs until every spawned coroutine has finished
+  void run();
+
+  // co_await executor.yield(): reschedules the caller behind the others
+  auto yield() noexcept {
+    struct Yield {
+      Executor& executor;
+      bool await_ready() noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> handle) {
+        executor.ready.push_back(handle);
+      }
+      void await_resume() noexcept {}
+    };
+    return Yield{*this};
+  }
+
+  // co_await executor.nextEdge(): parks the caller behind the coroutines
+  // already parked, it is resumed by the first poll that retries them
+  auto nextEdge() noexcept {
+    struct NextEdge : lf::ParkedAwaiter {
+      lf::EdgeNotifier& notifier;
+      bool await_ready() noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> handle) {
+        this->handle = handle;
+        notifier.park(*this);
+      }
+      void await_resume() noexcept {}
+    };
+    return NextEdge{
+        {[](lf::ParkedAwaiter&) noexcept { return true; }, {}}, edgeNotifier};
+  }
+
+  lf::EdgeNotifier& notifier() noexcept { return edgeNotifier; }
+
+ private:
+  std::deque<std::coroutine_handle<>> ready;
+  std::uint64_t liveCount = 0ull;
+  lf::EdgeNotifier edgeNotifier;
+};
+
+// thousands of coroutines per thread, each awaiting lf::nextId (or
+// lf::nextIds when batchSize > 1) and yielding to the others after every id
+class CoroutineTest : public ISnowflakeTest {
+ public:
+  CoroutineTest(std::string_view t_name, std::uint64_t t_threadCount,
+                std::uint64_t t_iterationCount, std::uint64_t t_coroutineCount,
+                std::uint64_t t_batchSize);
+
+  virtual void runTest() override;
+  virtual void runAnalysis() override { ISnowflakeTest::runAnalysis(); }
+
+ private:
+  // ids of one thread, appended in issue order by the coroutines of its
+  // executor
+  struct IdCursor {
+    std::span<std::uint64_t> ids;
+    std::size_t next = 0;
+    // a batch parked part way, no other batch may start before it completes
+    bool isBatchPending = false;
+  };
+
+  static Executor::Task generate(Executor& executor, IdCursor& cursor,
+                                 std::uint64_t batchSize);
+
+  std::uint64_t coroutineCount;
+  std::uint64_t batchSize;
+};
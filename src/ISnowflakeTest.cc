@@ -1,6 +1,11 @@
 #include "ISnowflakeTest.h"
 
+#include <lfsnowflake/sort.h>
+#include <lfsnowflake/stats.h>
+
 #include <fstream>
+#include <span>
+#include <thread>
 
 ISnowflakeTest::ISnowflakeTest(std::string_view t_name,
                                         std::uint64_t t_threadCount,
@@ -11,13 +16,7 @@ ISnowflakeTest::ISnowflakeTest(std::string_view t_name,
 
 // default function for runAnalysis
 void ISnowflakeTest::runAnalysis() {
-  // join into a single map
-  std::unordered_map<std::uint64_t, std::uint64_t> values;
-  for (const auto& workspace : workspaces) {
-    for (const auto id : workspace.idSequence) {
-      values[id]++;
-    }
-  }
+  const auto uniqueness = checkUniqueness();
 
   // if (iterationCount <= 65535ull) {
   //   std::vector<std::uint64_t> out;
@@ -65,27 +64,146 @@ void ISnowflakeTest::runAnalysis() {
 
   const auto totalIdCount = iterationCount * threadCount;
 
-  std::cout << "ID Count: " << values.size() << "/" << totalIdCount;
-  if (totalIdCount != values.size()) {
+  std::cout << "ID Count: " << uniqueness.uniqueCount << "/" << totalIdCount;
+  if (totalIdCount != uniqueness.uniqueCount) {
     std::cout << " [FAILED]";
   }
   std::cout << std::endl;
 
+  std::cout << "Duplicates: " << uniqueness.duplicateCount;
+  if (!uniqueness.firstDuplicates.empty()) {
+    std::cout << " first:";
+    for (const auto id : uniqueness.firstDuplicates) {
+      std::cout << ' ' << id;
+    }
+  }
+  std::cout << std::endl;
+  std::cout << "Order Violations: " << uniqueness.orderViolationCount
+            << std::endl;
+
   double idRate = ((double)iterationCount / averageThreadTime_ns * 1e6);
   std::cout << "# ids/ms: " << idRate << std::endl;
 
+  double idLatency_ns = averageThreadTime_ns / (double)iterationCount;
+  std::cout << "# ns/id: " << idLatency_ns << std::endl;
+
+  LatencyHistogram latency;
+  for (const auto& workspace : workspaces) {
+    latency.merge(workspace.latency);
+  }
+  if (latency.totalCount() != 0ull) {
+    std::cout << "Latency [ns]: p50 " << latency.percentile(50.0) << " p90 "
+              << latency.percentile(90.0) << " p99 "
+              << latency.percentile(99.0) << " p99.9 "
+              << latency.percentile(99.9) << " max " << latency.max()
+              << std::endl;
+  }
+
+  if (options.countEvents) {
+    PerfCounters::Values events;
+    for (const auto& workspace : workspaces) {
+      events += workspace.events;
+    }
+
+    bool isAnyAvailable = false;
+    std::cout << "Events/id:";
+    for (std::size_t i = 0; i < PerfCounters::kEventCount; i++) {
+      if (events.available[i]) {
+        std::cout << ' ' << PerfCounters::kEventNames[i] << ' '
+                  << (double)events.counts[i] / (double)totalIdCount;
+        isAnyAvailable = true;
+      }
+    }
+    if (!isAnyAvailable) {
+      std::cout << " unavailable (see /proc/sys/kernel/perf_event_paranoid)";
+    }
+    std::cout << std::endl;
+  }
+
+  // counters since the previous analysis, maxAhead is a gauge over the whole
+  // run
+  if constexpr (lf::stats::kEnabled) {
+    static lf::stats::Snapshot previous;
+    auto const stats = lf::stats::snapshot();
+    std::cout << "Stats: issued " << stats.issued - previous.issued
+              << " exhausted " << stats.exhausted - previous.exhausted
+              << " resetsWon " << stats.resetsWon - previous.resetsWon
+              << " casFailures " << stats.casFailures - previous.casFailures
+              << " borrowed " << stats.borrowed - previous.borrowed
+              << " maxAhead " << stats.maxAhead << std::endl;
+    previous = stats;
+  }
+
   std::cout << "--------------------------------" << std::endl << std::endl;
 
   // output to file for analysis
-  std::string path = std::format("../out/{}-t{}.txt", name, threadCount);
+  std::string path =
+      options.placement.empty()
+          ? std::format("../out/{}-t{}.txt", name, threadCount)
+          : std::format("../out/{}-t{}-{}.txt", name, threadCount,
+                        options.placement);
   std::ofstream file(path);
   if (!file.is_open()) {
     return;
   }
-  if (values.size() != totalIdCount) {
+  if (uniqueness.uniqueCount != totalIdCount) {
     file << 0.0;
   } else {
     file << idRate;
   }
   file.close();
-}
\ No newline at end of file
+}
+
+ISnowflakeTest::Uniqueness ISnowflakeTest::checkUniqueness() {
+  Uniqueness uniqueness;
+
+  // every thread's ids must be strictly increasing, count the violations
+  // before sorting; the sequences are mostly sorted, so sort only if needed
+  std::vector<std::uint64_t> orderViolationCounts(std::size(workspaces));
+  {
+    std::vector<std::jthread> jThreadPool;
+    for (auto i = 0ull; i < std::size(workspaces); i++) {
+      jThreadPool.emplace_back([&sequence = workspaces[i].idSequence,
+                                &violationCount = orderViolationCounts[i]]() {
+        for (auto j = 1ull; j < std::size(sequence); j++) {
+          if (sequence[j] <= sequence[j - 1]) {
+            violationCount++;
+          }
+        }
+        if (violationCount != 0ull) {
+          std::vector<std::uint64_t> scratch(std::size(sequence));
+          lf::sort::radixSort(sequence, scratch, 64ull);
+        }
+      });
+    }
+  }
+  for (const auto violationCount : orderViolationCounts) {
+    uniqueness.orderViolationCount += violationCount;
+  }
+
+  // k-way merge of the sorted sequences, equal neighbours are duplicates
+  std::vector<std::span<const std::uint64_t>> runs;
+  for (const auto& workspace : workspaces) {
+    runs.emplace_back(workspace.idSequence);
+  }
+
+  bool isFirst = true;
+  std::uint64_t previous = 0ull;
+  lf::sort::forEachMerged(runs, [&](std::uint64_t id) {
+    if (isFirst || id != previous) {
+      uniqueness.uniqueCount++;
+    } else {
+      // report each duplicated id once
+      if ((uniqueness.firstDuplicates.size() < kReportedDuplicateCount) &&
+          (uniqueness.firstDuplicates.empty() ||
+           uniqueness.firstDuplicates.back() != id)) {
+        uniqueness.firstDuplicates.push_back(id);
+      }
+      uniqueness.duplicateCount++;
+    }
+    isFirst = false;
+    previous = id;
+  });
+
+  return uniqueness;
+}
@@ -5,9 +5,11 @@
 #include <format>
 #include <iostream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "LatencyHistogram.h"
+#include "PerfCounters.h"
+
 namespace utils {
 
 inline std::uint64_t millis() noexcept {
@@ -36,9 +38,23 @@ inline std::uint64_t epoch() noexcept {
 
 class ISnowflakeTest {
  public:
+  // settings shared by every test of a run
+  struct Options {
+    // time every call and report latency percentiles
+    bool recordLatency = false;
+    // count hardware events around the measured loop
+    bool countEvents = false;
+    // logical cpus the threads are pinned to round robin, empty: unpinned
+    std::vector<int> cpus;
+    // name of the thread placement, empty when unpinned
+    std::string_view placement;
+  };
+
   explicit ISnowflakeTest(std::string_view t_name, std::uint64_t t_threadCount,
                           std::uint64_t t_iterationCount);
 
+  void setOptions(Options const& t_options) noexcept { options = t_options; }
+
   virtual void runTest() = 0;
   virtual void runAnalysis() = 0;
 
@@ -52,15 +68,38 @@ class ISnowflakeTest {
   std::uint64_t threadCount;
   std::uint64_t iterationCount;
 
+  Options options;
+
   struct Workspace {
     // sequence of unique ids for this thread
     std::vector<std::uint64_t> idSequence;
     // start and end times for this thread
     std::chrono::nanoseconds duration_ns;
+    // per call latency, including the retries after a 0
+    LatencyHistogram latency;
+    // hardware events of the measured loop
+    PerfCounters::Values events;
   };
 
   std::vector<Workspace> workspaces;
 
+  // result of the uniqueness check over every workspace
+  struct Uniqueness {
+    std::uint64_t uniqueCount = 0ull;
+    std::uint64_t duplicateCount = 0ull;
+    // smallest duplicated ids, at most kReportedDuplicateCount
+    std::vector<std::uint64_t> firstDuplicates;
+    // ids not greater than the previous id of the same thread
+    std::uint64_t orderViolationCount = 0ull;
+  };
+
+  static constexpr std::size_t kReportedDuplicateCount = 8;
+
+  // counts ordering violations per thread, radix sorts the out of order
+  // idSequences (one thread per workspace) and streams the sorted sequences
+  // through a loser tree merge, no merged copy of the ids is made
+  Uniqueness checkUniqueness();
+
  protected:
   class comma_numpunct : public std::numpunct<char> {
    protected:
@@ -0,0 +1,83 @@
+#include "IpcTest.h"
+
+#include <lfsnowflake/ipc.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <span>
+#include <thread>
+#include <vector>
+
+IpcTest::IpcTest(std::string_view t_name, std::uint64_t t_threadCount,
+                 std::uint64_t t_iterationCount, std::uint64_t t_batchSize,
+                 std::uint64_t t_depth)
+    : ISnowflakeTest(t_name, t_threadCount, t_iterationCount),
+      batchSize(std::max<std::uint64_t>(t_batchSize, 1ull)),
+      depth(std::max<std::uint64_t>(t_depth, 1ull)) {}
+
+void IpcTest::runTest() {
+  std::cout << "Running Test: " << name << std::endl;
+
+  auto const path = "/tmp/lfsnowflake-test-" + std::to_string(::getpid()) +
+                    ".sock";
+  lf::ipc::Server server(path.c_str());
+  if (!server.isOpen()) {
+    std::cout << "failed to listen on " << path << std::endl;
+    return;
+  }
+  std::jthread serverThread(
+      [&server](std::stop_token stopToken) { server.run(stopToken); });
+
+  std::vector<std::jthread> jThreadPool;
+  std::atomic_flag flag(false);
+  std::atomic<std::uint64_t> counter(0);
+
+  workspaces.resize(threadCount);
+  for (auto& workspace : workspaces) {
+    workspace.idSequence.resize(iterationCount);
+    auto callable = [this, &path, &flag, &counter](Workspace& workspace) {
+      lf::ipc::Client client(path.c_str());
+
+      // wait for thread synchronization
+      counter.fetch_add(1ull, std::memory_order_acq_rel);
+      flag.wait(false, std::memory_order_acquire);
+
+      const auto begin = std::chrono::steady_clock::now();
+
+      std::span<std::uint64_t> ids(workspace.idSequence);
+      auto const roundSize = static_cast<std::size_t>(batchSize * depth);
+      for (std::size_t i = 0; i < std::size(ids) && client.isOpen();) {
+        auto const round =
+            ids.subspan(i, std::min(roundSize, std::size(ids) - i));
+        const auto roundBegin = std::chrono::steady_clock::now();
+        if (roundSize == 1) {
+          round[0] = client.get(0ull);
+        } else if (depth == 1) {
+          client.getBatch(0ull, round);
+        } else {
+          client.getPipelined(0ull, round, batchSize, depth);
+        }
+        if (options.recordLatency) {
+          const auto roundEnd = std::chrono::steady_clock::now();
+          workspace.latency.record(static_cast<std::uint64_t>(
+              std::chrono::nanoseconds(roundEnd - roundBegin).count()));
+        }
+        i += std::size(round);
+      }
+
+      const auto end = std::chrono::steady_clock::now();
+      workspace.duration_ns = end - begin;
+    };
+
+    jThreadPool.emplace_back(callable, std::ref(workspace));
+  }
+
+  // synchronize threads
+  while (counter.load(std::memory_order_acquire) != threadCount) {
+    std::this_thread::yield();
+  }
+  flag.test_and_set(std::memory_order_release);
+  flag.notify_all();
+}
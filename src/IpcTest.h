@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "ISnowflakeTest.h"
+
+// lf::ipc::Client against an in-process lf::ipc::Server, one connection per
+// thread. Ids are requested in batches of batchSize with up to depth requests
+// in flight (batchSize 1 and depth 1 is one round trip per id), with -l the
+// latency of every round of batchSize * depth ids is recorded
+class IpcTest : public ISnowflakeTest {
+ public:
+  IpcTest(std::string_view t_name, std::uint64_t t_threadCount,
+          std::uint64_t t_iterationCount, std::uint64_t t_batchSize,
+          std::uint64_t t_depth);
+
+  virtual void runTest() override;
+  virtual void runAnalysis() override { ISnowflakeTest::runAnalysis(); }
+
+ private:
+  std::uint64_t batchSize;
+  std::uint64_t depth;
+};
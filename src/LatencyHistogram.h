@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// log-bucketed (HDR style) histogram of latencies in nanoseconds, values are
+// kept with kSubBucketBits bits of precision (~3% relative error), so
+// recording is an index computation and an increment
+class LatencyHistogram {
+ public:
+  static constexpr std::uint64_t kSubBucketBits = 5ull;
+  static constexpr std::uint64_t kSubBucketCount = 1ull << kSubBucketBits;
+  // values [0, 2 * kSubBucketCount) are exact, every power of two above has
+  // kSubBucketCount buckets
+  static constexpr std::size_t kBucketCount =
+      (64ull - kSubBucketBits) * kSubBucketCount + kSubBucketCount;
+
+  void record(std::uint64_t value) noexcept {
+    m_Counts[index(value)]++;
+    m_Count++;
+    m_Maximum = std::max(m_Maximum, value);
+  }
+
+  void merge(LatencyHistogram const& other) noexcept {
+    for (std::size_t i = 0; i < kBucketCount; i++) {
+      m_Counts[i] += other.m_Counts[i];
+    }
+    m_Count += other.m_Count;
+    m_Maximum = std::max(m_Maximum, other.m_Maximum);
+  }
+
+  // highest value equivalent to the value at percentile [0, 100]
+  std::uint64_t percentile(double percentile) const noexcept {
+    if (m_Count == 0ull) {
+      return 0ull;
+    }
+    auto const target = std::max<std::uint64_t>(
+        1ull, static_cast<std::uint64_t>(percentile / 100.0 * (double)m_Count));
+    std::uint64_t seen = 0ull;
+    for (std::size_t i = 0; i < kBucketCount; i++) {
+      seen += m_Counts[i];
+      if (seen >= target) {
+        return std::min(highestEquivalent(i), m_Maximum);
+      }
+    }
+    return m_Maximum;
+  }
+
+  std::uint64_t totalCount() const noexcept { return m_Count; }
+  std::uint64_t max() const noexcept { return m_Maximum; }
+
+ private:
+  static std::size_t index(std::uint64_t value) noexcept {
+    if (value < 2ull * kSubBucketCount) {
+      return static_cast<std::size_t>(value);
+    }
+    // keep the top kSubBucketBits + 1 bits, the leading one selects the half
+    auto const shift = static_cast<std::uint64_t>(std::bit_width(value)) -
+                       (kSubBucketBits + 1ull);
+    return static_cast<std::size_t>(shift * kSubBucketCount +
+                                    (value >> shift));
+  }
+
+  static std::uint64_t highestEquivalent(std::size_t index) noexcept {
+    if (index < 2ull * kSubBucketCount) {
+      return index;
+    }
+    auto const shift = index / kSubBucketCount - 1ull;
+    auto const subBucket = index % kSubBucketCount + kSubBucketCount;
+    return ((subBucket + 1ull) << shift) - 1ull;
+  }
+
+  std::array<std::uint64_t, kBucketCount> m_Counts{};
+  std::uint64_t m_Count = 0ull;
+  std::uint64_t m_Maximum = 0ull;
+};
@@ -0,0 +1,118 @@
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+PerfCounters::Values& PerfCounters::Values::operator+=(
+    Values const& other) noexcept {
+  for (std::size_t i = 0; i < kEventCount; i++) {
+    counts[i] += other.counts[i];
+    available[i] = available[i] || other.available[i];
+  }
+  return *this;
+}
+
+#if defined(__linux__)
+namespace {
+struct EventConfig {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+constexpr std::uint64_t cacheEvent(std::uint64_t cache, std::uint64_t op,
+                                   std::uint64_t result) noexcept {
+  return cache | (op << 8) | (result << 16);
+}
+
+constexpr std::array<EventConfig, PerfCounters::kEventCount> kEventConfigs = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE,
+     cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE,
+     cacheEvent(PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ,
+                PERF_COUNT_HW_CACHE_RESULT_MISS)},
+}};
+}  // namespace
+
+PerfCounters::PerfCounters(bool isEnabled) noexcept {
+  m_Fds.fill(-1);
+  if (!isEnabled) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < kEventCount; i++) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = kEventConfigs[i].type;
+    attr.config = kEventConfigs[i].config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // calling thread, any cpu, no group
+    m_Fds[i] = static_cast<int>(
+        ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+  }
+}
+
+PerfCounters::~PerfCounters() noexcept {
+  for (auto const fd : m_Fds) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+}
+
+void PerfCounters::start() noexcept {
+  for (auto const fd : m_Fds) {
+    if (fd >= 0) {
+      ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void PerfCounters::stop() noexcept {
+  for (auto const fd : m_Fds) {
+    if (fd >= 0) {
+      ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+}
+
+PerfCounters::Values PerfCounters::read() const noexcept {
+  Values values;
+  for (std::size_t i = 0; i < kEventCount; i++) {
+    if (m_Fds[i] < 0) {
+      continue;
+    }
+    // value, time enabled, time running
+    std::uint64_t buffer[3];
+    if ((::read(m_Fds[i], buffer, sizeof(buffer)) != sizeof(buffer)) ||
+        (buffer[2] == 0ull)) {
+      continue;
+    }
+    values.counts[i] = static_cast<std::uint64_t>(
+        (double)buffer[0] * (double)buffer[1] / (double)buffer[2]);
+    values.available[i] = true;
+  }
+  return values;
+}
+#else
+PerfCounters::PerfCounters(bool) noexcept { m_Fds.fill(-1); }
+PerfCounters::~PerfCounters() noexcept = default;
+void PerfCounters::start() noexcept {}
+void PerfCounters::stop() noexcept {}
+PerfCounters::Values PerfCounters::read() const noexcept { return {}; }
+#endif
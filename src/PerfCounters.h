@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// hardware event counters of the calling thread (perf_event_open), counting
+// user space only. Events the kernel or the cpu does not provide (ie. with
+// perf_event_paranoid > 2, or in a VM) are marked unavailable and skipped
+class PerfCounters {
+ public:
+  enum Event : std::size_t {
+    kCycles,
+    kInstructions,
+    kL1dMisses,
+    kLlcMisses,
+    // loads served by another NUMA node (cross-socket traffic)
+    kNodeMisses,
+    kEventCount
+  };
+
+  static constexpr std::array<std::string_view, kEventCount> kEventNames = {
+      "cycles", "instructions", "L1D-misses", "LLC-misses", "node-misses"};
+
+  struct Values {
+    std::array<std::uint64_t, kEventCount> counts{};
+    std::array<bool, kEventCount> available{};
+
+    Values& operator+=(Values const& other) noexcept;
+  };
+
+  // opens the counters of the calling thread when isEnabled, else a no-op
+  explicit PerfCounters(bool isEnabled) noexcept;
+  ~PerfCounters() noexcept;
+
+  PerfCounters(PerfCounters const&) = delete;
+  PerfCounters& operator=(PerfCounters const&) = delete;
+
+  void start() noexcept;
+  void stop() noexcept;
+  // counts between start and stop, scaled up when the kernel multiplexed
+  Values read() const noexcept;
+
+ private:
+  std::array<int, kEventCount> m_Fds;
+};
@@ -0,0 +1,117 @@
+#include "SharedMemoryTest.h"
+
+#include <lfsnowflake/shared.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace {
+// shared between the parent and the forked processes, the ids follow it
+struct Control {
+  std::atomic<std::uint64_t> readyCount;
+  std::atomic<bool> start;
+};
+}  // namespace
+
+SharedMemoryTest::SharedMemoryTest(std::string_view t_name,
+                                   std::uint64_t t_processCount,
+                                   std::uint64_t t_iterationCount)
+    : ISnowflakeTest(t_name, t_processCount, t_iterationCount) {}
+
+void SharedMemoryTest::runTest() {
+  std::cout << "Running Test: " << name << std::endl;
+
+  auto const segmentName = "/lfsnowflake-test-" + std::to_string(::getpid());
+  lf::SharedGenerator<>::remove(segmentName.c_str());
+
+  // control block, per process durations and ids
+  auto const idCount = threadCount * iterationCount;
+  auto const size = sizeof(Control) + threadCount * sizeof(std::int64_t) +
+                    idCount * sizeof(std::uint64_t);
+  void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    std::cout << "mmap failed" << std::endl;
+    return;
+  }
+  auto* control = ::new (mapping) Control{};
+  auto* durations_ns = reinterpret_cast<std::int64_t*>(control + 1);
+  auto* ids = reinterpret_cast<std::uint64_t*>(durations_ns + threadCount);
+
+  // processes that were never forked count as failed to attach
+  auto forkCount = 0ull;
+  for (auto process = 0ull; process < threadCount; process++) {
+    auto const pid = ::fork();
+    if (pid < 0) {
+      std::cout << "fork failed" << std::endl;
+      break;
+    }
+    if (pid != 0) {
+      forkCount++;
+      continue;
+    }
+
+    // child: attach, wait for every process, generate and leave
+    lf::SharedGenerator<> generator(segmentName.c_str());
+    if (!generator.isOpen()) {
+      ::_exit(1);
+    }
+    control->readyCount.fetch_add(1ull, std::memory_order_acq_rel);
+    while (!control->start.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    auto* processIds = ids + process * iterationCount;
+    std::uint64_t val;
+    for (auto i = 0ull; i < iterationCount; i++) {
+      while (val = generator.get(0ull), val == 0ull) {
+        std::this_thread::yield();
+      }
+      processIds[i] = val;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    durations_ns[process] = std::chrono::nanoseconds(end - begin).count();
+    ::_exit(0);
+  }
+
+  // synchronize processes, a child that failed to attach never becomes ready
+  bool isReady = forkCount == threadCount;
+  while (isReady &&
+         (control->readyCount.load(std::memory_order_acquire) != threadCount)) {
+    int status;
+    if (::waitpid(-1, &status, WNOHANG) > 0) {
+      isReady = false;
+      break;
+    }
+    std::this_thread::yield();
+  }
+  control->start.store(true, std::memory_order_release);
+
+  bool isFailed = !isReady;
+  int status;
+  while (::wait(&status) > 0) {
+    isFailed = isFailed || !WIFEXITED(status) || (WEXITSTATUS(status) != 0);
+  }
+  if (isFailed) {
+    std::cout << "a process failed to attach to " << segmentName << std::endl;
+  }
+
+  workspaces.resize(threadCount);
+  for (auto process = 0ull; process < threadCount; process++) {
+    auto& workspace = workspaces[process];
+    auto const* processIds = ids + process * iterationCount;
+    workspace.idSequence.assign(processIds, processIds + iterationCount);
+    workspace.duration_ns = std::chrono::nanoseconds(durations_ns[process]);
+  }
+
+  ::munmap(mapping, size);
+  lf::SharedGenerator<>::remove(segmentName.c_str());
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "ISnowflakeTest.h"
+
+// lf::SharedGenerator used by threadCount forked processes instead of threads,
+// the ids are collected through a shared mapping and analysed as usual
+class SharedMemoryTest : public ISnowflakeTest {
+ public:
+  SharedMemoryTest(std::string_view t_name, std::uint64_t t_processCount,
+                   std::uint64_t t_iterationCount);
+
+  virtual void runTest() override;
+  virtual void runAnalysis() override { ISnowflakeTest::runAnalysis(); }
+};
@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "Affinity.h"
 #include "ISnowflakeTest.h"
 
 template <std::uint64_t (*generator)(std::uint64_t)>
@@ -20,7 +21,11 @@ struct SnowFlakeTest : ISnowflakeTest {
   virtual void runTest() override {
     std::vector<std::jthread> jThreadPool;
 
-    std::cout << "Running Test: " << name << std::endl;
+    std::cout << "Running Test: " << name;
+    if (!options.placement.empty()) {
+      std::cout << " [" << options.placement << "]";
+    }
+    std::cout << std::endl;
 
     std::atomic_flag flag(false);
     std::atomic<std::uint64_t> counter(0);
@@ -28,26 +33,52 @@ struct SnowFlakeTest : ISnowflakeTest {
     workspaces.resize(threadCount);
     for (auto& workspace : workspaces) {
       workspace.idSequence.resize(iterationCount);
-      auto callable = [&flag, &counter](Workspace& workspace) -> void {
+      auto callable = [&flag, &counter, recordLatency = options.recordLatency,
+                       countEvents = options.countEvents](
+                          Workspace& workspace) -> void {
+        PerfCounters counters(countEvents);
+
         // wait for thread synchronization
         counter.fetch_add(1ull, std::memory_order_acq_rel);
         flag.wait(false, std::memory_order_acquire);
 
         const auto begin = std::chrono::steady_clock::now();
+        counters.start();
 
         std::uint64_t val;
-        for (auto i = 0ull; i < workspace.idSequence.size(); i++) {
-          while (val = generator(0ull), val == 0ull) {
-            std::this_thread::yield();
+        if (recordLatency) {
+          for (auto i = 0ull; i < workspace.idSequence.size(); i++) {
+            const auto callBegin = std::chrono::steady_clock::now();
+            while (val = generator(0ull), val == 0ull) {
+              std::this_thread::yield();
+            }
+            const auto callEnd = std::chrono::steady_clock::now();
+            workspace.latency.record(static_cast<std::uint64_t>(
+                std::chrono::nanoseconds(callEnd - callBegin).count()));
+            workspace.idSequence[i] = val;
+          }
+        } else {
+          for (auto i = 0ull; i < workspace.idSequence.size(); i++) {
+            while (val = generator(0ull), val == 0ull) {
+              std::this_thread::yield();
+            }
+            workspace.idSequence[i] = val;
           }
-          workspace.idSequence[i] = val;
         }
 
+        counters.stop();
         const auto end = std::chrono::steady_clock::now();
         workspace.duration_ns = end - begin;
+        workspace.events = counters.read();
       };
 
       jThreadPool.emplace_back(callable, std::ref(workspace));
+      // pinned before the threads are released below
+      if (!options.cpus.empty()) {
+        affinity::pin(jThreadPool.back(),
+                      options.cpus[(std::size(jThreadPool) - 1) %
+                                   std::size(options.cpus)]);
+      }
     }
 
     // synchronize threads
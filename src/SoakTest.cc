@@ -0,0 +1,148 @@
+#include "SoakTest.h"
+
+#include <lfsnowflake/layout.h>
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+SoakTest::SoakTest(std::string_view t_name, Generator t_generator,
+                   std::uint64_t t_threadCount, std::chrono::seconds t_duration)
+    : name(t_name),
+      generator(t_generator),
+      threadCount(t_threadCount),
+      duration(t_duration) {}
+
+void SoakTest::produce(Queue& queue, std::atomic<bool> const& stop) noexcept {
+  std::uint64_t previous = 0ull;
+  auto tail = queue.atm_Tail.load(std::memory_order_relaxed);
+  while (!stop.load(std::memory_order_relaxed)) {
+    // wait for the verifier to free a chunk
+    while (tail - queue.atm_Head.load(std::memory_order_acquire) ==
+           kQueueDepth) {
+      std::this_thread::yield();
+    }
+
+    auto& chunk = queue.chunks[tail % kQueueDepth];
+    for (auto& id : chunk) {
+      while (id = generator(0ull), id == 0ull) {
+        std::this_thread::yield();
+      }
+      if (id <= previous) {
+        queue.orderViolationCount++;
+      }
+      previous = id;
+    }
+    queue.atm_Tail.store(++tail, std::memory_order_release);
+  }
+  queue.atm_Done.store(true, std::memory_order_release);
+}
+
+void SoakTest::verify(Chunk const& chunk) noexcept {
+  using Layout = lf::DefaultLayout;
+  for (auto const id : chunk) {
+    auto const timestamp = Layout::getTimestamp(id);
+    auto const sequence = Layout::getSequence(id);
+
+    auto& slot = window[timestamp % kWindow_ms];
+    if (slot.timestamp != timestamp) {
+      if (slot.timestamp > timestamp) {
+        // the slot already holds a newer millisecond
+        lateCount++;
+        continue;
+      }
+      slot.timestamp = timestamp;
+      slot.bits.fill(0ull);
+    }
+
+    auto const bit = 1ull << (sequence % 64ull);
+    auto& word = slot.bits[sequence / 64ull];
+    if ((word bitand bit) != 0ull) {
+      duplicateCount++;
+    }
+    word |= bit;
+  }
+  idCount += kChunkSize;
+}
+
+void SoakTest::runTest() {
+  std::cout << "Running Soak Test: " << name << " for " << duration.count()
+            << " s" << std::endl;
+
+  queues.clear();
+  for (auto i = 0ull; i < threadCount; i++) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  window.assign(kWindow_ms, Slot{0ull, {}});
+  idCount = duplicateCount = lateCount = orderViolationCount = 0ull;
+
+  std::atomic<bool> stop{false};
+  auto const begin = std::chrono::steady_clock::now();
+  {
+    std::vector<std::jthread> jThreadPool;
+    for (auto& queue : queues) {
+      jThreadPool.emplace_back(
+          [this, &stop](Queue& queue) { produce(queue, stop); },
+          std::ref(*queue));
+    }
+
+    // the calling thread is the verifier
+    auto nextReport = begin + kReportInterval;
+    auto doneCount = 0ull;
+    while (doneCount != threadCount) {
+      doneCount = 0ull;
+      bool isIdle = true;
+      for (auto& queue : queues) {
+        // load done before the tail, so no chunk published before it is missed
+        bool const isDone = queue->atm_Done.load(std::memory_order_acquire);
+        auto head = queue->atm_Head.load(std::memory_order_relaxed);
+        auto const tail = queue->atm_Tail.load(std::memory_order_acquire);
+        for (; head != tail; head++) {
+          verify(queue->chunks[head % kQueueDepth]);
+          queue->atm_Head.store(head + 1ull, std::memory_order_release);
+          isIdle = false;
+        }
+        doneCount += isDone ? 1ull : 0ull;
+      }
+
+      auto const now = std::chrono::steady_clock::now();
+      if (now - begin >= duration) {
+        stop.store(true, std::memory_order_relaxed);
+      }
+      if (now >= nextReport) {
+        nextReport += kReportInterval;
+        std::cout << "  "
+                  << std::chrono::duration_cast<std::chrono::seconds>(now -
+                                                                      begin)
+                         .count()
+                  << " s: " << idCount << " ids, " << duplicateCount
+                  << " duplicates" << std::endl;
+      }
+      if (isIdle) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  duration_ns = std::chrono::steady_clock::now() - begin;
+
+  for (auto const& queue : queues) {
+    orderViolationCount += queue->orderViolationCount;
+  }
+}
+
+void SoakTest::runAnalysis() {
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Execution Time: " << (double)duration_ns.count() << std::endl;
+  std::cout << "ID Count: " << idCount;
+  if ((duplicateCount != 0ull) || (orderViolationCount != 0ull)) {
+    std::cout << " [FAILED]";
+  }
+  std::cout << std::endl;
+  std::cout << "Duplicates: " << duplicateCount << std::endl;
+  std::cout << "Order Violations: " << orderViolationCount << std::endl;
+  std::cout << "Late (outside window): " << lateCount << std::endl;
+  std::cout << "# ids/ms: "
+            << (double)idCount / (double)duration_ns.count() * 1e6
+            << std::endl;
+  std::cout << "--------------------------------" << std::endl << std::endl;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Streaming verification of a generator for long (soak) runs. Every thread
+// checks that its own ids are strictly increasing and hands them in chunks to
+// a single verifier thread through a lock free single producer queue. Ids of
+// millisecond T can only collide with other ids of millisecond T, so the
+// verifier keeps one bitset of sequence numbers per millisecond for a sliding
+// window of kWindow_ms milliseconds. Memory use is independent of the run time
+class SoakTest {
+ public:
+  using Generator = std::uint64_t (*)(std::uint64_t);
+
+  // ids per chunk handed to the verifier
+  static constexpr std::size_t kChunkSize = 4'096;
+  // chunks per thread queue, producers wait while their queue is full
+  static constexpr std::size_t kQueueDepth = 64;
+  // milliseconds verified at once, older ids are counted as late
+  static constexpr std::uint64_t kWindow_ms = 4'096ull;
+  // how often the verifier prints its progress
+  static constexpr std::chrono::seconds kReportInterval{10};
+
+  SoakTest(std::string_view t_name, Generator t_generator,
+           std::uint64_t t_threadCount, std::chrono::seconds t_duration);
+
+  void runTest();
+  void runAnalysis();
+
+ private:
+  using Chunk = std::array<std::uint64_t, kChunkSize>;
+
+  // single producer single consumer ring of chunks, the producer fills the
+  // chunk at tail in place and publishes it by advancing the tail
+  struct Queue {
+    alignas(64) std::atomic<std::uint64_t> atm_Head{0ull};
+    alignas(64) std::atomic<std::uint64_t> atm_Tail{0ull};
+    std::atomic<bool> atm_Done{false};
+    // ids not greater than the previous id of the same thread
+    std::uint64_t orderViolationCount = 0ull;
+    std::array<Chunk, kQueueDepth> chunks;
+  };
+
+  // sequence numbers seen in one millisecond
+  struct Slot {
+    std::uint64_t timestamp;
+    std::array<std::uint64_t, 64> bits;
+  };
+
+  void produce(Queue& queue, std::atomic<bool> const& stop) noexcept;
+  void verify(Chunk const& chunk) noexcept;
+
+  std::string_view name;
+  Generator generator;
+  std::uint64_t threadCount;
+  std::chrono::seconds duration;
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<Slot> window;
+
+  std::uint64_t idCount = 0ull;
+  std::uint64_t duplicateCount = 0ull;
+  std::uint64_t lateCount = 0ull;
+  std::uint64_t orderViolationCount = 0ull;
+  std::chrono::nanoseconds duration_ns{};
+};
@@ -0,0 +1,133 @@
+#include "SortTest.h"
+
+#include <lfsnowflake/sort.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <span>
+#include <utility>
+
+namespace {
+using u64 = std::uint64_t;
+
+// binary heap merge, the baseline for the loser tree
+void heapMerge(std::span<std::span<u64 const> const> runs,
+               std::span<u64> out) {
+  using Cursor = std::pair<u64, std::size_t>;
+  std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heap;
+  std::vector<std::size_t> positions(std::size(runs), 0);
+  for (auto i = 0ull; i < std::size(runs); i++) {
+    if (!runs[i].empty()) {
+      heap.emplace(runs[i].front(), i);
+    }
+  }
+
+  std::size_t i = 0;
+  while (!heap.empty()) {
+    auto const [id, index] = heap.top();
+    heap.pop();
+    if (++positions[index] < std::size(runs[index])) {
+      heap.emplace(runs[index][positions[index]], index);
+    }
+    out[i++] = id;
+  }
+}
+
+template <typename Callable>
+double rate_Mps(u64 idCount, Callable&& callable) {
+  auto const begin = std::chrono::steady_clock::now();
+  callable();
+  auto const end = std::chrono::steady_clock::now();
+  return (double)idCount /
+         (double)std::chrono::duration_cast<std::chrono::microseconds>(end -
+                                                                       begin)
+             .count();
+}
+}  // namespace
+
+SortTest::SortTest(std::uint64_t t_idCount, std::uint64_t t_threadCount)
+    : idCount(t_idCount),
+      threadCount(std::max<std::uint64_t>(t_threadCount, 1ull)) {}
+
+void SortTest::runTest() {
+  std::cout << "Running Test: lf::sort" << std::endl;
+
+  // ids of one generator handed to random threads: every thread's run is
+  // ordered, the concatenation of the runs is not
+  std::mt19937_64 random(0ull);
+  auto const baseTimestamp = lf::DefaultLayout::toTicks(1ull << 40);
+  std::vector<std::vector<u64>> runIds(threadCount);
+  for (auto& ids : runIds) {
+    // room for the random imbalance between the runs
+    ids.reserve(idCount / threadCount + idCount / threadCount / 64 + 1'024);
+  }
+  for (auto i = 0ull; i < idCount; i++) {
+    runIds[random() % threadCount].push_back(lf::DefaultLayout::make(
+        baseTimestamp + (i >> 12), 1ull, i bitand 4'095ull));
+  }
+
+  std::vector<std::span<u64 const>> runs(std::begin(runIds), std::end(runIds));
+  // the unsorted input: the runs one after the other
+  auto const concatenate = [&](std::vector<u64>& values) {
+    values.clear();
+    for (auto const& ids : runIds) {
+      values.insert(std::end(values), std::begin(ids), std::end(ids));
+    }
+  };
+
+  // the std::sort result is the reference for the others
+  std::vector<u64> expected;
+  concatenate(expected);
+  results.clear();
+  results.push_back({"std::sort", rate_Mps(idCount, [&]() {
+                       std::sort(std::begin(expected), std::end(expected));
+                     }),
+                     true});
+
+  std::vector<u64> values;
+  std::vector<u64> scratch(idCount);
+  concatenate(values);
+  results.push_back(
+      {"lf::sort::radixSort (1 thread)", rate_Mps(idCount, [&]() {
+         lf::sort::radixSort<>(values, scratch);
+       }),
+       values == expected});
+
+  if (threadCount > 1) {
+    concatenate(values);
+    results.push_back({"lf::sort::radixSort (-t threads)",
+                       rate_Mps(idCount, [&]() {
+                         lf::sort::radixSort<>(values, scratch, threadCount);
+                       }),
+                       values == expected});
+  }
+
+  results.push_back(
+      {"std::priority_queue merge",
+       rate_Mps(idCount, [&]() { heapMerge(runs, values); }),
+       values == expected});
+
+  results.push_back(
+      {"lf::sort::merge (loser tree)",
+       rate_Mps(idCount, [&]() { lf::sort::merge(runs, values); }),
+       values == expected});
+}
+
+void SortTest::runAnalysis() {
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "ID Count: " << idCount << " Runs: " << threadCount
+            << std::endl;
+  for (auto const& result : results) {
+    std::cout << result.name << ": " << result.rate_Mps << " M ids/s";
+    if (!result.valid) {
+      std::cout << " [FAILED]";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "--------------------------------" << std::endl << std::endl;
+}
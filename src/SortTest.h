@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// throughput of lf::sort::radixSort and the lf::sort::merge loser tree
+// against std::sort and a binary heap merge, over per thread runs of ids
+class SortTest {
+ public:
+  explicit SortTest(std::uint64_t t_idCount, std::uint64_t t_threadCount);
+
+  void runTest();
+  void runAnalysis();
+
+ private:
+  struct Result {
+    std::string_view name;
+    // millions of ids ordered per second
+    double rate_Mps;
+    bool valid;
+  };
+
+  std::uint64_t idCount;
+  std::uint64_t threadCount;
+
+  std::vector<Result> results;
+};
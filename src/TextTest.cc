@@ -0,0 +1,291 @@
+#include "TextTest.h"
+
+#include <lfsnowflake/text.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <limits>
+#include <span>
+#include <string>
+
+#include "Timing.h"
+
+namespace {
+using u64 = std::uint64_t;
+
+// fixed width strings of ascending ids must be ascending
+bool isSorted(std::span<char const> text, std::size_t width) {
+  for (std::size_t i = width; i < std::size(text); i += width) {
+    if (std::memcmp(std::data(text) + i - width, std::data(text) + i, width) >=
+        0) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+TextTest::TextTest(std::uint64_t t_idCount) : idCount(t_idCount) {}
+
+void TextTest::runTest() {
+  std::cout << "Running Test: lf::text" << std::endl;
+
+  // time ordered snowflakes (19 decimal digits) with random mpids
+  std::mt19937_64 random(0ull);
+  std::vector<u64> snowflakes(idCount);
+  for (auto i = 0ull; i < idCount; i++) {
+    snowflakes[i] = lf::DefaultLayout::make((1ull << 40) + (i >> 12),
+                                            random() % 1'024ull,
+                                            i bitand 4'095ull);
+  }
+  std::sort(std::begin(snowflakes), std::end(snowflakes));
+  snowflakes.erase(std::unique(std::begin(snowflakes), std::end(snowflakes)),
+                   std::end(snowflakes));
+  auto const count = std::size(snowflakes);
+
+  results.clear();
+
+  // decimal: std::to_chars output is the reference
+  std::vector<char> expected(count * (lf::text::kDecimalMaxSize + 1));
+  std::size_t expectedSize = 0;
+  results.push_back({"std::to_chars", timing::bestRate_Mps(count, [&]() {
+                       auto* end = std::data(expected);
+                       for (auto const snowflake : snowflakes) {
+                         end = std::to_chars(
+                                   end, end + lf::text::kDecimalMaxSize,
+                                   snowflake)
+                                   .ptr;
+                         *end++ = '\n';
+                       }
+                       expectedSize =
+                           static_cast<std::size_t>(end - std::data(expected));
+                     }),
+                     true});
+
+  std::vector<std::string> strings(count);
+  results.push_back({"std::to_string", timing::bestRate_Mps(count, [&]() {
+                       for (std::size_t i = 0; i < count; i++) {
+                         strings[i] = std::to_string(snowflakes[i]);
+                       }
+                     }),
+                     true});
+
+  auto const isa = lf::bulk::detectIsa();
+  bool const isAvx2 = isa != lf::bulk::Isa::kScalar;
+  std::vector<char> decimal(std::size(expected));
+  std::size_t decimalSize = 0;
+  auto const isDecimalValid = [&]() {
+    return (decimalSize == expectedSize) &&
+           std::equal(std::begin(decimal),
+                      std::begin(decimal) +
+                          static_cast<std::ptrdiff_t>(decimalSize),
+                      std::begin(expected));
+  };
+  results.push_back(
+      {"lf::text::scalar::encodeDecimal", timing::bestRate_Mps(count, [&]() {
+         decimalSize =
+             lf::text::scalar::encodeDecimal(snowflakes, decimal, '\n');
+       }),
+       isDecimalValid()});
+#if defined(__x86_64__)
+  if (isAvx2) {
+    results.push_back(
+        {"lf::text::avx2::encodeDecimal", timing::bestRate_Mps(count, [&]() {
+           decimalSize =
+               lf::text::avx2::encodeDecimal(snowflakes, decimal, '\n');
+         }),
+         isDecimalValid()});
+  }
+#endif
+
+  std::vector<u64> decoded(count);
+  results.push_back({"lf::text::fromChars", timing::bestRate_Mps(count, [&]() {
+                       std::string_view text(std::data(expected), expectedSize);
+                       for (auto& snowflake : decoded) {
+                         auto const end = text.find('\n');
+                         lf::text::fromChars(text.substr(0, end), snowflake);
+                         text.remove_prefix(end + 1);
+                       }
+                     }),
+                     decoded == snowflakes});
+
+  // fixed width encodings: sorted and round tripped
+  using Encoder = void (*)(std::span<u64 const>, std::span<char>) noexcept;
+  using Decoder = bool (*)(std::span<char const>, std::span<u64>) noexcept;
+  struct Kernel {
+    std::string_view encodeName;
+    std::string_view decodeName;
+    std::size_t width;
+    Encoder encode;
+    Decoder decode;
+    bool supported;
+  };
+  std::vector<Kernel> kernels = {
+      {"lf::text::scalar::encodeBase32", "lf::text::scalar::decodeBase32",
+       lf::text::kBase32Size, lf::text::scalar::encodeBase32,
+       lf::text::scalar::decodeBase32, true},
+#if defined(__x86_64__)
+      {"lf::text::avx2::encodeBase32", "lf::text::avx2::decodeBase32",
+       lf::text::kBase32Size, lf::text::avx2::encodeBase32,
+       lf::text::avx2::decodeBase32, lf::text::detail::hasAvx2()},
+#endif
+      {"lf::text::scalar::encodeBase62", "lf::text::scalar::decodeBase62",
+       lf::text::kBase62Size, lf::text::scalar::encodeBase62,
+       lf::text::scalar::decodeBase62, true},
+#if defined(__x86_64__)
+      // base62 decodes with the scalar kernel only
+      {"lf::text::avx2::encodeBase62",
+       "lf::text::scalar::decodeBase62 (avx2 encoded)", lf::text::kBase62Size,
+       lf::text::avx2::encodeBase62, lf::text::scalar::decodeBase62, isAvx2},
+#endif
+  };
+
+  std::vector<char> text(count * lf::text::kBase32Size);
+  for (auto const& kernel : kernels) {
+    if (!kernel.supported) {
+      continue;
+    }
+
+    auto const chars = std::span(text).first(count * kernel.width);
+    results.push_back({kernel.encodeName, timing::bestRate_Mps(count, [&]() {
+                         kernel.encode(snowflakes, chars);
+                       }),
+                       isSorted(chars, kernel.width)});
+    std::fill(std::begin(decoded), std::end(decoded), 0ull);
+    bool isDecoded = true;
+    results.push_back({kernel.decodeName, timing::bestRate_Mps(count, [&]() {
+                         isDecoded = kernel.decode(chars, decoded);
+                       }),
+                       isDecoded && (decoded == snowflakes)});
+  }
+
+  runChecks();
+}
+
+void TextTest::runChecks() {
+  checkCount = 0;
+  failedChecks.clear();
+  auto const check = [&](std::string_view name, bool isPassed) {
+    checkCount++;
+    if (!isPassed) {
+      failedChecks.emplace_back(name);
+    }
+  };
+
+  // every digit count the decimal kernels branch on
+  std::vector<u64> const values = {0ull,
+                                   9ull,
+                                   10ull,
+                                   9'999ull,
+                                   10'000ull,
+                                   9'999'999'999'999'999ull,
+                                   10'000'000'000'000'000ull,
+                                   10'000'000'000'000'000'000ull,
+                                   std::numeric_limits<u64>::max()};
+  auto const count = std::size(values);
+
+  std::string expected;
+  bool isParsed = true;
+  for (auto const value : values) {
+    auto const digits = std::to_string(value);
+    expected += digits + ' ';
+    u64 parsed = 0ull;
+    isParsed = isParsed && lf::text::fromChars(digits, parsed) &&
+               (parsed == value);
+  }
+  check("lf::text::fromChars boundary values", isParsed);
+
+  std::vector<char> decimal(count * (lf::text::kDecimalMaxSize + 1));
+  auto const isDecimal = [&](std::size_t size) {
+    return std::string_view(std::data(decimal), size) == expected;
+  };
+  check("lf::text::scalar::encodeDecimal boundary values",
+        isDecimal(lf::text::scalar::encodeDecimal(values, decimal, ' ')));
+#if defined(__x86_64__)
+  if (lf::bulk::detectIsa() != lf::bulk::Isa::kScalar) {
+    check("lf::text::avx2::encodeDecimal boundary values",
+          isDecimal(lf::text::avx2::encodeDecimal(values, decimal, ' ')));
+  }
+#endif
+
+  // fixed width boundary values through the scalar and the dispatched kernels
+  std::vector<char> text(count * lf::text::kBase32Size);
+  std::vector<u64> decoded(count);
+  auto const base32 = std::span(text).first(count * lf::text::kBase32Size);
+  lf::text::encodeBase32(values, base32);
+  check("lf::text::encodeBase32 boundary values",
+        lf::text::scalar::decodeBase32(base32, decoded) && (decoded == values));
+  lf::text::scalar::encodeBase32(values, base32);
+  check("lf::text::decodeBase32 boundary values",
+        lf::text::decodeBase32(base32, decoded) && (decoded == values));
+  auto const base62 = std::span(text).first(count * lf::text::kBase62Size);
+  lf::text::encodeBase62(values, base62);
+  check("lf::text::encodeBase62 boundary values",
+        lf::text::scalar::decodeBase62(base62, decoded) && (decoded == values));
+
+  // crockford: case insensitive, I and L read as 1, O as 0
+  std::string_view const aliases = "0000000000ILO0000000000ilo";
+  std::vector<u64> const aliasValues = {1'056ull, 1'056ull};
+  u64 value = 0ull;
+  check("lf::text::fromBase32 aliases",
+        lf::text::fromBase32(aliases.substr(0, lf::text::kBase32Size),
+                             value) &&
+            (value == 1'056ull));
+  check("lf::text::scalar::decodeBase32 aliases",
+        lf::text::scalar::decodeBase32(aliases, std::span(decoded).first(2)) &&
+            std::equal(std::begin(aliasValues), std::end(aliasValues),
+                       std::begin(decoded)));
+  check("lf::text::decodeBase32 aliases",
+        lf::text::decodeBase32(aliases, std::span(decoded).first(2)) &&
+            std::equal(std::begin(aliasValues), std::end(aliasValues),
+                       std::begin(decoded)));
+
+  // invalid chars, values past 2^64 and wrong lengths are rejected
+  check("lf::text::fromChars invalid input",
+        !lf::text::fromChars("", value) && !lf::text::fromChars("-1", value) &&
+            !lf::text::fromChars("12a", value) &&
+            !lf::text::fromChars("18446744073709551616", value) &&
+            !lf::text::fromChars("100000000000000000000", value));
+  check("lf::text::fromBase32 invalid input",
+        !lf::text::fromBase32("0000000000U00", value) &&
+            !lf::text::fromBase32("G000000000000", value) &&
+            !lf::text::fromBase32("000000000000", value) &&
+            !lf::text::fromBase32("00000000000000", value));
+  check("lf::text::fromBase62 invalid input",
+        !lf::text::fromBase62("0000000000-", value) &&
+            !lf::text::fromBase62("zzzzzzzzzzz", value) &&
+            !lf::text::fromBase62("0000000000", value) &&
+            !lf::text::fromBase62("000000000000", value));
+  // the invalid char is in the second string
+  auto const invalid32 = std::string(2 * lf::text::kBase32Size - 2, '0') + "U0";
+  check("lf::text::decodeBase32 invalid input",
+        !lf::text::scalar::decodeBase32(invalid32,
+                                        std::span(decoded).first(2)) &&
+            !lf::text::decodeBase32(invalid32, std::span(decoded).first(2)));
+  auto const invalid62 = std::string(2 * lf::text::kBase62Size - 1, '0') + "-";
+  check("lf::text::decodeBase62 invalid input",
+        !lf::text::decodeBase62(invalid62, std::span(decoded).first(2)));
+}
+
+void TextTest::runAnalysis() {
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "ID Count: " << idCount << std::endl;
+  for (auto const& result : results) {
+    std::cout << result.name << ": " << result.rate_Mps << " M ids/s";
+    if (!result.valid) {
+      std::cout << " [FAILED]";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "Checks: " << checkCount - std::size(failedChecks) << "/"
+            << checkCount << std::endl;
+  for (auto const& name : failedChecks) {
+    std::cout << name << " [FAILED]" << std::endl;
+  }
+  std::cout << "--------------------------------" << std::endl << std::endl;
+}
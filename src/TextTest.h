@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// throughput of the lf::text encoders/decoders against std::to_string and
+// std::to_chars, every result is checked by a round trip. Boundary values and
+// invalid input are checked separately on every kernel
+class TextTest {
+ public:
+  explicit TextTest(std::uint64_t t_idCount);
+
+  void runTest();
+  void runAnalysis();
+
+ private:
+  void runChecks();
+
+  struct Result {
+    std::string_view name;
+    // millions of ids converted per second
+    double rate_Mps;
+    bool valid;
+  };
+
+  std::uint64_t idCount;
+
+  std::vector<Result> results;
+  std::uint64_t checkCount = 0;
+  std::vector<std::string> failedChecks;
+};
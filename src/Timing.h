@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace timing {
+// number of passes per kernel, the fastest pass is reported
+inline constexpr auto kPassCount = 5;
+
+// fastest of kPassCount calls of callable
+template <typename Callable>
+std::chrono::nanoseconds bestTime(Callable&& callable) {
+  auto best = std::chrono::nanoseconds::max();
+  for (auto pass = 0; pass < kPassCount; pass++) {
+    auto const begin = std::chrono::steady_clock::now();
+    callable();
+    auto const end = std::chrono::steady_clock::now();
+    best = std::min<std::chrono::nanoseconds>(best, end - begin);
+  }
+  return best;
+}
+
+// GB/s of the fastest pass over byteCount bytes
+template <typename Callable>
+double bestRate_GBps(std::uint64_t byteCount, Callable&& callable) {
+  return (double)byteCount / (double)bestTime(callable).count();
+}
+
+// millions of items per second of the fastest pass over count items
+template <typename Callable>
+double bestRate_Mps(std::uint64_t count, Callable&& callable) {
+  return (double)count * 1e3 / (double)bestTime(callable).count();
+}
+}  // namespace timing
@@ -0,0 +1,100 @@
+#include "WideTest.h"
+
+#include <lfsnowflake/wide.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <locale>
+#include <thread>
+#include <utility>
+#include <vector>
+
+WideTest::WideTest(std::string_view t_name, std::uint64_t t_threadCount,
+                   std::uint64_t t_iterationCount, std::uint64_t t_batchSize)
+    : ISnowflakeTest(t_name, t_threadCount, t_iterationCount),
+      batchSize(std::max<std::uint64_t>(t_batchSize, 1ull)) {}
+
+std::uint64_t WideTest::mpid(std::size_t i) noexcept {
+  return 0xfeed'0000'0000'0000ull + static_cast<std::uint64_t>(i);
+}
+
+void WideTest::runTest() {
+  std::vector<std::jthread> jThreadPool;
+
+  std::cout << "Running Test: " << name << std::endl;
+
+  std::atomic_flag flag(false);
+  std::atomic<std::uint64_t> counter(0);
+
+  workspaces.resize(threadCount);
+  lowWords.assign(threadCount, {});
+  for (std::size_t t = 0; t < threadCount; t++) {
+    workspaces[t].idSequence.resize(iterationCount);
+    lowWords[t].resize(iterationCount);
+    auto callable = [this, &flag, &counter, t]() -> void {
+      auto& workspace = workspaces[t];
+      auto& lows = lowWords[t];
+      std::vector<lf::wide::Id> batch(batchSize);
+
+      // wait for thread synchronization
+      counter.fetch_add(1ull, std::memory_order_acq_rel);
+      flag.wait(false, std::memory_order_acquire);
+
+      const auto begin = std::chrono::steady_clock::now();
+      for (std::size_t i = 0; i < iterationCount;) {
+        std::size_t count = 0;
+        if (batchSize == 1ull) {
+          batch[0] = lf::wide::get(mpid(t));
+          count = (batch[0].high != 0ull) ? 1 : 0;
+        } else {
+          count = lf::wide::getBatch(
+              mpid(t), std::min<std::uint64_t>(batchSize, iterationCount - i),
+              batch);
+        }
+        if (count == 0) {
+          std::this_thread::yield();
+          continue;
+        }
+        for (std::size_t k = 0; k < count; k++, i++) {
+          workspace.idSequence[i] = batch[k].high;
+          lows[i] = batch[k].low;
+        }
+      }
+      const auto end = std::chrono::steady_clock::now();
+      workspace.duration_ns = end - begin;
+    };
+
+    jThreadPool.emplace_back(callable);
+  }
+
+  // synchronize threads
+  while (counter.load(std::memory_order_acquire) != threadCount) {
+    std::this_thread::yield();
+  }
+  flag.test_and_set(std::memory_order_release);
+  flag.notify_all();
+}
+
+void WideTest::runAnalysis() {
+  // both words: every low word is its thread's MPID, no 128 bit id repeats
+  std::uint64_t mismatchCount = 0ull;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> ids;
+  ids.reserve(threadCount * iterationCount);
+  for (std::size_t t = 0; t < threadCount; t++) {
+    for (std::size_t i = 0; i < std::size(lowWords[t]); i++) {
+      mismatchCount += (lowWords[t][i] != mpid(t)) ? 1ull : 0ull;
+      ids.emplace_back(workspaces[t].idSequence[i], lowWords[t][i]);
+    }
+  }
+  std::sort(std::begin(ids), std::end(ids));
+  auto const uniqueCount = static_cast<std::uint64_t>(
+      std::unique(std::begin(ids), std::end(ids)) - std::begin(ids));
+
+  std::locale comma_locale(std::locale(), new comma_numpunct());
+  std::cout.imbue(comma_locale);
+  std::cout << "MPID Mismatches: " << mismatchCount << std::endl;
+  std::cout << "128 bit Duplicates: " << std::size(ids) - uniqueCount
+            << std::endl;
+  ISnowflakeTest::runAnalysis();
+}
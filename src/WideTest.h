@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "ISnowflakeTest.h"
+
+// lf::wide::get (or lf::wide::getBatch when batchSize > 1) on every thread,
+// each thread with its own 64 bit MPID. The high words go through the usual
+// analysis, the low words must match their thread's MPID and the 128 bit ids
+// must be unique
+class WideTest : public ISnowflakeTest {
+ public:
+  WideTest(std::string_view t_name, std::uint64_t t_threadCount,
+           std::uint64_t t_iterationCount, std::uint64_t t_batchSize);
+
+  virtual void runTest() override;
+  virtual void runAnalysis() override;
+
+ private:
+  // MPID of thread i, uses the top bits of the low word
+  static std::uint64_t mpid(std::size_t i) noexcept;
+
+  std::uint64_t batchSize;
+  // low word of every id, per thread
+  std::vector<std::vector<std::uint64_t>> lowWords;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <lfsnowflake/lockfree.h>
+
+#include <cstdint>
+
+namespace burst {
+template <std::uint64_t Ticks>
+struct Generator : lf::Generator {
+  Generator() noexcept { setBurstCredit(Ticks); }
+};
+
+// generator allowed to run Ticks milliseconds ahead of the clock
+template <std::uint64_t Ticks>
+inline std::uint64_t get(std::uint64_t mpid) noexcept {
+  static Generator<Ticks> generator;
+  return generator.get(mpid);
+}
+}  // namespace burst
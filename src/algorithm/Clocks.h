@@ -0,0 +1,17 @@
+#pragma once
+
+#include <lfsnowflake/lockfree.h>
+
+#include <cstdint>
+
+namespace clocks {
+// one generator per clock source so the tests do not share a sequence, owned
+// by the running ClockTest
+template <typename Clock>
+inline lf::BasicGenerator<Clock>* g_Generator = nullptr;
+
+template <typename Clock>
+inline std::uint64_t get(std::uint64_t mpid) noexcept {
+  return g_Generator<Clock>->get(mpid);
+}
+}  // namespace clocks
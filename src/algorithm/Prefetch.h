@@ -0,0 +1,28 @@
+#pragma once
+
+#include <lfsnowflake/ring.h>
+
+#include <cstdint>
+
+namespace prefetch {
+// popped snowflakes are at most this many milliseconds old
+inline constexpr std::uint64_t kMaxAge_ms = 2ull;
+
+// the rings take ids from their own generator, so their producers do not
+// compete with the other tests for the process-wide sequence
+inline lf::Generator g_Generator;
+
+// one producer per consumer thread
+inline std::uint64_t getSpsc(std::uint64_t mpid) noexcept {
+  thread_local lf::IdPrefetcher<lf::SpscRing<1'024>> tl_Prefetcher(
+      mpid, kMaxAge_ms, g_Generator);
+  return tl_Prefetcher.get();
+}
+
+// one producer shared by every consumer thread
+inline std::uint64_t getMpmc(std::uint64_t mpid) noexcept {
+  static lf::IdPrefetcher<lf::MpmcRing<4'096>> prefetcher(mpid, kMaxAge_ms,
+                                                          g_Generator);
+  return prefetcher.get();
+}
+}  // namespace prefetch